@@ -0,0 +1,490 @@
+// Microbenchmarks for the chunk pipeline (no SFML needed).
+// Usage: bench [name...]   (default: run every benchmark)
+#include "chunks.hpp"
+#include "gridlayout.hpp"
+#include "noise.hpp"
+#include "terrain.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <list>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Keeps the optimizer from discarding benchmarked work
+volatile uint64_t g_sink = 0;
+
+// Runs fn(iters) and reports the per-iteration cost (returned, in ns)
+double report(const char* label, uint64_t iters, const std::function<void(uint64_t)>& fn) {
+    auto t0 = Clock::now();
+    fn(iters);
+    double ns = std::chrono::duration<double, std::nano>(Clock::now() - t0).count() / (double)iters;
+    std::printf("  %-40s %10.2f ns/op\n", label, ns);
+    return ns;
+}
+
+// Random resident keys: an 11x11 window, the same shape as the visible set
+std::vector<ChunkKey> residentKeys(size_t lookups) {
+    std::mt19937 rng(1234);
+    std::uniform_int_distribution<int> d(-5, 5);
+    std::vector<ChunkKey> keys(lookups);
+    for (auto& k : keys) k = ChunkKey{d(rng), d(rng)};
+    return keys;
+}
+
+// ---- cache: hit path of the chunk cache ----
+void benchCache() {
+    const int resident = 121; // 11x11 window
+    std::printf("cache (hit path, %d resident chunks)\n", resident);
+    const uint64_t N = 20000000;
+    const std::vector<ChunkKey> keys = residentKeys(1 << 16);
+    const size_t kmask = keys.size() - 1;
+    struct Payload { uint32_t lastFrame = 0; int value = 0; };
+
+    // Before: unordered_map + std::list LRU, hit path as the old getChunk had it (erase the
+    // list node, push a new one to the front: one free and one allocation per hit)
+    {
+        struct Node { Payload p; std::list<ChunkKey>::iterator it; };
+        std::unordered_map<ChunkKey, Node, ChunkKeyHash> map;
+        std::list<ChunkKey> lru;
+        for (int x = -5; x <= 5; ++x) for (int y = -5; y <= 5; ++y) {
+            lru.push_front(ChunkKey{x, y});
+            map[ChunkKey{x, y}] = Node{Payload{0, x * 31 + y}, lru.begin()};
+        }
+        report("unordered_map + list LRU", N, [&](uint64_t n){
+            uint64_t acc = 0;
+            for (uint64_t i = 0; i < n; ++i) {
+                auto it = map.find(keys[i & kmask]);
+                lru.erase(it->second.it);
+                lru.push_front(it->first);
+                it->second.it = lru.begin();
+                it->second.p.lastFrame = (uint32_t)i;
+                acc += (uint64_t)it->second.p.value;
+            }
+            g_sink = acc;
+        });
+    }
+    // After: flat open-addressing index + CLOCK reference bit
+    {
+        ClockCache<ChunkKey, Payload, ChunkKeyHash> cache((size_t)resident);
+        for (int x = -5; x <= 5; ++x) for (int y = -5; y <= 5; ++y)
+            cache.insert(ChunkKey{x, y}, Payload{0, x * 31 + y});
+        report("ClockCache", N, [&](uint64_t n){
+            uint64_t acc = 0;
+            for (uint64_t i = 0; i < n; ++i) {
+                Payload* p = cache.get(keys[i & kmask]);
+                p->lastFrame = (uint32_t)i;
+                acc += (uint64_t)p->value;
+            }
+            g_sink = acc;
+        });
+    }
+    // End to end: ChunkManager::getChunk on resident chunks
+    {
+        ChunkManager mgr;
+        mgr.setMode(ChunkManager::Mode::Procedural, 1337u);
+        for (int x = -5; x <= 5; ++x) for (int y = -5; y <= 5; ++y) mgr.getChunk(x, y);
+        report("ChunkManager::getChunk (hit)", N, [&](uint64_t n){
+            uint64_t acc = 0;
+            for (uint64_t i = 0; i < n; ++i) {
+                const ChunkKey& k = keys[i & kmask];
+                acc += (uint64_t)mgr.getChunk(k.cx, k.cy).height(0);
+            }
+            g_sink = acc;
+        });
+    }
+}
+
+// ---- tier: compressed second tier vs regeneration ----
+void benchTier() {
+    std::printf("tier (restore an evicted chunk)\n");
+    ChunkManager mgr;
+    mgr.setMode(ChunkManager::Mode::Procedural, 1337u);
+    const int n = 64;
+    std::vector<uint8_t> blob;
+    size_t total = 0;
+    report("generate (getChunk miss)", n, [&](uint64_t iters){
+        for (uint64_t i = 0; i < iters; ++i) g_sink = (uint64_t)mgr.getChunk((int)i, 7).height(0);
+    });
+    const Chunk& src = mgr.getChunk(3, 7);
+    Chunk out;
+    report("compress", 20000, [&](uint64_t iters){
+        for (uint64_t i = 0; i < iters; ++i) { CompressedChunkCache::compress(src, blob); total = blob.size(); }
+    });
+    report("decompress", 20000, [&](uint64_t iters){
+        for (uint64_t i = 0; i < iters; ++i) CompressedChunkCache::decompress(blob.data(), blob.size(), out);
+        g_sink = (uint64_t)out.height(0);
+    });
+    std::printf("  %-40s %10zu bytes (raw heights %zu)\n", "compressed size", total, (size_t)ChunkPool::BLOCK_BYTES);
+}
+
+// ---- edit: one brush stroke step (31x31 square across a chunk corner) ----
+void benchEdit() {
+    std::printf("edit (31x31 brush over 4 chunks)\n");
+    ChunkManager mgr;
+    mgr.setMode(ChunkManager::Mode::Procedural, 1337u);
+    const int S = cfg::CHUNK_SIZE, half = 15;
+    mgr.editRegion(S - half, S - half, S + half, S + half, ChunkManager::EditOp::Add, 0); // load chunks
+    const uint64_t n = 2000;
+    report("per-vertex applyDeltaAt", n, [&](uint64_t iters){
+        for (uint64_t it = 0; it < iters; ++it)
+            for (int I = S - half; I <= S + half; ++I)
+                for (int J = S - half; J <= S + half; ++J) mgr.applyDeltaAt(I, J, (it & 1) ? 1 : -1);
+    });
+    report("editRegion", n, [&](uint64_t iters){
+        for (uint64_t it = 0; it < iters; ++it)
+            mgr.editRegion(S - half, S - half, S + half, S + half, ChunkManager::EditOp::Add, (it & 1) ? 1 : -1);
+    });
+    mgr.resetOverrides(); // leave no journal behind
+}
+
+// ---- read: bake a (GRID+1)^2 window from resident chunks ----
+void benchRead() {
+    std::printf("read (%dx%d bake window, resident chunks)\n", cfg::GRID + 1, cfg::GRID + 1);
+    ChunkManager mgr;
+    mgr.setMode(ChunkManager::Mode::Procedural, 1337u);
+    const int S = cfg::CHUNK_SIZE, W = cfg::GRID + 1, I0 = -W / 2, J0 = -W / 2;
+    std::vector<int> out((size_t)W * W);
+    mgr.readRegion(I0, J0, I0 + W - 1, J0 + W - 1, ChunkManager::Layer::Composited, out.data(), 0, 1 << 20);
+    const uint64_t n = 50;
+    report("per-vertex getChunk", n, [&](uint64_t iters){
+        for (uint64_t it = 0; it < iters; ++it)
+            for (int i = 0; i < W; ++i)
+                for (int j = 0; j < W; ++j) {
+                    int I = I0 + i, J = J0 + j;
+                    int cx = (I >= 0) ? I / S : (I - (S - 1)) / S;
+                    int cy = (J >= 0) ? J / S : (J - (S - 1)) / S;
+                    out[(size_t)i * W + j] = mgr.getChunk(cx, cy).height(Chunk::idx(I - cx * S, J - cy * S));
+                }
+    });
+    report("readRegion", n, [&](uint64_t iters){
+        for (uint64_t it = 0; it < iters; ++it)
+            mgr.readRegion(I0, J0, I0 + W - 1, J0 + W - 1, ChunkManager::Layer::Composited, out.data());
+    });
+    g_sink = (uint64_t)out[0];
+}
+
+// ---- water: acquiring the visible set for the water-only view ----
+void benchWater() {
+    std::printf("water (21x21 chunks, cold cache)\n");
+    auto run = [](const char* label, ChunkManager::Layer need){
+        ChunkManager mgr;
+        mgr.setMode(ChunkManager::Mode::Procedural, 1337u);
+        report(label, 441, [&](uint64_t){
+            for (int x = -10; x <= 10; ++x)
+                for (int y = -10; y <= 10; ++y) g_sink = (uint64_t)mgr.getChunk(x, y, need).overrideAt(0);
+        });
+        std::printf("  %-40s %10zu bytes\n", "resident", mgr.cacheStats().bytes);
+    };
+    run("getChunk (terrain generated)", ChunkManager::Layer::Composited);
+    run("getChunk (edits only)", ChunkManager::Layer::Overrides);
+}
+
+// ---- memory: bytes held per resident chunk ----
+void benchMemory() {
+    std::printf("memory (per resident chunk)\n");
+    // Previous layout: int heights + int overrides + byte mask, one block
+    const size_t before = ((size_t)2 * ChunkPool::VERTS + (ChunkPool::VERTS + 3) / 4) * sizeof(int);
+    auto line = [before](const char* label, const Chunk& ch){
+        std::printf("  %-40s %10zu bytes (was %zu)\n", label, ch.bytes(), before);
+    };
+    Chunk ch;
+    line("flat (shared uniform block)", ch);
+    ch.setHeight(0, 1);
+    line("unedited", ch);
+    for (int i = 0; i < 31; ++i) for (int j = 0; j < 31; ++j) ch.setOverride(Chunk::idx(i, j), 10);
+    line("31x31 brush edited", ch);
+    for (int k = 0; k < ChunkPool::VERTS; ++k) ch.setOverride(k, 10);
+    line("fully edited", ch);
+}
+
+// ---- noise: fbm throughput, one sample at a time vs batched rows vs lattice-cached grid ----
+void benchNoise() {
+    std::printf("noise (5-octave fbm at the base chunk scale, batched path: %s)\n", noise::simdPath());
+    const int N = cfg::CHUNK_SIZE + 1;
+    const float f = cfg::NOISE_BASE_SCALE / (float)cfg::GRID;
+    std::vector<float> xs((size_t)N), ys((size_t)N), out((size_t)N);
+    for (int j = 0; j < N; ++j) { xs[(size_t)j] = 17 * f; ys[(size_t)j] = (float)(j - 1000) * f; }
+    const uint64_t samples = (uint64_t)N * 40000;
+    auto rate = [](double ns){ std::printf("  %-40s %10.1f Msamples/s\n", "  throughput", 1e3 / ns); };
+    rate(report("fbm (per sample)", samples, [&](uint64_t n){
+        float acc = 0.f;
+        for (uint64_t r = 0; r < n / N; ++r)
+            for (int j = 0; j < N; ++j) acc += noise::fbm(xs[(size_t)j] + (float)(r & 7), ys[(size_t)j], 1337u);
+        g_sink = (uint64_t)acc;
+    }));
+    rate(report("fbmRow (per sample)", samples, [&](uint64_t n){
+        float acc = 0.f;
+        for (uint64_t r = 0; r < n / N; ++r) {
+            for (int j = 0; j < N; ++j) xs[(size_t)j] = 17 * f + (float)(r & 7);
+            noise::fbmRow(xs.data(), ys.data(), N, out.data(), 1337u);
+            acc += out[0];
+        }
+        g_sink = (uint64_t)acc;
+    }));
+    std::vector<float> block((size_t)N * N);
+    rate(report("fbmBlock 61x61, cached (per sample)", samples, [&](uint64_t n){
+        for (uint64_t b = 0; b < n / ((uint64_t)N * N); ++b)
+            noise::fbmBlock((int)b * N, -N, N, N, f, block.data(), 1337u);
+        g_sink = (uint64_t)block[0];
+    }));
+}
+
+// Makespan of tasks claimed in order by t threads, each thread taking the next task once free
+double scheduleMakespan(const std::vector<double>& costs, unsigned t) {
+    std::vector<double> busy(t, 0.0);
+    for (double c : costs) *std::min_element(busy.begin(), busy.end()) += c;
+    return *std::max_element(busy.begin(), busy.end());
+}
+
+// ---- threads: generateMap row bands and generateChunks batches vs thread count ----
+void benchThreads() {
+    const unsigned hw = std::max(1u, std::thread::hardware_concurrency());
+    std::printf("threads (calling thread + pool workers, %u hardware threads)\n", hw);
+    std::vector<unsigned> counts{1, 2, 4, 8};
+    if (hw > 8) counts.push_back(hw);
+    if (hw < 8) std::printf("  note: fewer than 8 hardware threads, counts above %u only measure oversubscription\n", hw);
+    // Speedup over one thread and parallel efficiency (speedup / threads)
+    auto speedup = [hw](unsigned t, double base, double ns) {
+        std::printf("  %-40s %10.2fx  (%3.0f%% efficiency%s)\n", "  speedup", base / ns, 100.0 * base / ns / t,
+                    t > hw ? ", oversubscribed" : "");
+    };
+    std::vector<int> map;
+    double base = 0.0;
+    for (unsigned t : counts) {
+        ThreadPool pool(t > 1 ? t - 1 : 1);
+        const std::string label = "generateMap 301x301, " + std::to_string(t) + (t > 1 ? " threads" : " thread");
+        const double ns = report(label.c_str(), 8, [&](uint64_t n){
+            for (uint64_t r = 0; r < n; ++r) terrain::generateMap(map, 1337u + (uint32_t)r, t > 1 ? &pool : nullptr);
+            g_sink = (uint64_t)map[0];
+        });
+        if (t == 1) base = ns;
+        speedup(t, base, ns);
+    }
+    // 8x8 chunks per batch; a fresh manager each time so every chunk is generated
+    std::vector<ChunkKey> keys;
+    for (int x = 0; x < 8; ++x) for (int y = 0; y < 8; ++y) keys.push_back(ChunkKey{x, y});
+    for (unsigned t : counts) {
+        const std::string label = "generateChunks, " + std::to_string(t) + (t > 1 ? " threads" : " thread") + " (per chunk)";
+        const double ns = report(label.c_str(), keys.size() * 4, [&](uint64_t n){
+            for (uint64_t b = 0; b < n / keys.size(); ++b) {
+                ChunkManager mgr(t > 1 ? t - 1 : 1);
+                mgr.setMode(ChunkManager::Mode::Procedural, 1337u + (uint32_t)b);
+                if (t > 1) g_sink = (uint64_t)mgr.generateChunks(keys);
+                else for (const ChunkKey& k : keys) g_sink = (uint64_t)mgr.getChunk(k.cx, k.cy).height(0);
+            }
+        });
+        if (t == 1) base = ns;
+        speedup(t, base, ns);
+    }
+    // Upper bound from the partition alone: the tasks' single-thread times scheduled on t
+    // threads with no contention. Not a measurement; it shows whether the split could reach
+    // 8 cores when the machine running the bench has fewer.
+    std::printf("  partition bound (single-thread task times, no memory or lock contention)\n");
+    const int bands = (cfg::GRID + 1 + cfg::TERRAIN_BAND_ROWS - 1) / cfg::TERRAIN_BAND_ROWS;
+    const std::vector<double> bandCosts((size_t)bands, 1.0); // equal-width bands of uniform noise work
+    std::vector<double> chunkCosts(keys.size(), 0.0);
+    for (uint32_t r = 0; r < 4; ++r) {
+        ChunkManager mgr(1);
+        mgr.setMode(ChunkManager::Mode::Procedural, 7331u + r);
+        for (size_t k = 0; k < keys.size(); ++k) {
+            auto t0 = Clock::now();
+            g_sink = (uint64_t)mgr.getChunk(keys[k].cx, keys[k].cy).height(0);
+            chunkCosts[k] += std::chrono::duration<double, std::nano>(Clock::now() - t0).count();
+        }
+    }
+    double mapTotal = 0.0, chunkTotal = 0.0;
+    for (double c : bandCosts) mapTotal += c;
+    for (double c : chunkCosts) chunkTotal += c;
+    for (unsigned t : counts) {
+        const std::string label = "  " + std::to_string(t) + (t > 1 ? " threads" : " thread") + ": generateMap";
+        std::printf("  %-40s %10.2fx  generateChunks %.2fx\n", label.c_str(),
+                    mapTotal / scheduleMakespan(bandCosts, t), chunkTotal / scheduleMakespan(chunkCosts, t));
+    }
+}
+
+// ---- levels: coarse resolution levels against full chunks ----
+void benchLevels() {
+    std::printf("levels (chunks a zoomed-out view builds, per chunk)\n");
+    std::vector<ChunkKey> keys;
+    for (int x = 0; x < 16; ++x) for (int y = 0; y < 16; ++y) keys.push_back(ChunkKey{x, y});
+    uint32_t seed = 4242u;
+    for (int level = 0; level < cfg::CHUNK_LOD_LEVELS; ++level) {
+        const std::string label = "level " + std::to_string(level) + ", stride " + std::to_string(ChunkManager::levelStride(level));
+        report(label.c_str(), keys.size() * 2, [&](uint64_t n){
+            for (uint64_t b = 0; b < n / keys.size(); ++b) {
+                ChunkManager mgr(1);
+                mgr.setMode(ChunkManager::Mode::Procedural, seed++);
+                if (level == 0) for (const ChunkKey& k : keys) g_sink = (uint64_t)mgr.getChunk(k.cx, k.cy).height(0);
+                else g_sink = (uint64_t)mgr.buildLevel(keys, level, (int)keys.size());
+            }
+        });
+    }
+    // Sampled from resident full chunks instead of generated (each level built once)
+    ChunkManager mgr(1);
+    mgr.setMode(ChunkManager::Mode::Procedural, seed);
+    for (const ChunkKey& k : keys) g_sink = (uint64_t)mgr.getChunk(k.cx, k.cy).height(0);
+    for (int level = 1; level < cfg::CHUNK_LOD_LEVELS; ++level) {
+        const std::string label = "level " + std::to_string(level) + " sampled from resident chunks";
+        report(label.c_str(), keys.size(), [&](uint64_t){ g_sink = (uint64_t)mgr.buildLevel(keys, level, (int)keys.size()); });
+    }
+}
+
+// ---- preview: time to first pixel of a freshly exposed 11x11 window ----
+void benchPreview() {
+    std::printf("preview (background generation of an 11x11 window, %d preview octaves)\n", cfg::CHUNK_PREVIEW_OCTAVES);
+    const int R = 5, side = 2 * R + 1;
+    ChunkManager mgr(1);
+    mgr.setMode(ChunkManager::Mode::Procedural, 2468u);
+    mgr.setViewFocus(0, 0, R);
+    std::vector<double> first((size_t)side * side, -1.0), full((size_t)side * side, -1.0);
+    const auto t0 = Clock::now();
+    for (int left = side * side; left > 0; ) {
+        mgr.pumpCompleted();
+        const double ms = std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+        for (int cx = -R; cx <= R; ++cx) {
+            for (int cy = -R; cy <= R; ++cy) {
+                const size_t k = (size_t)(cx + R) * side + (size_t)(cy + R);
+                if (full[k] >= 0) continue;
+                if (mgr.tryPin(cx, cy)) { full[k] = ms; --left; }
+                else if (!mgr.previewHeights(cx, cy)) continue;
+                if (first[k] < 0) first[k] = ms;
+            }
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+    double a = 0, b = 0, am = 0, bm = 0;
+    for (size_t k = 0; k < full.size(); ++k) { a += first[k]; b += full[k]; am = std::max(am, first[k]); bm = std::max(bm, full[k]); }
+    std::printf("  %-40s %10.2f ms (last %.2f ms)\n", "first pixel, mean", a / full.size(), am);
+    std::printf("  %-40s %10.2f ms (last %.2f ms)\n", "full detail, mean", b / full.size(), bm);
+}
+
+// ---- layout: shadow march and quad normals over each vertex order ----
+template <typename L>
+std::vector<int16_t> toLayout(const std::vector<int16_t>& rowMajor) {
+    std::vector<int16_t> h(L::SLOTS);
+    for (int i = 0; i < L::SIDE; ++i)
+        L::forRow(i, 0, L::SIDE - 1, [&](int j, int k){ h[(size_t)k] = rowMajor[(size_t)i * L::SIDE + j]; });
+    return h;
+}
+
+// The renderer's shadow march (draw2DFilledCellsChunk) from every vertex, light along (dx, dy)
+template <typename L>
+uint64_t shadowPass(const int16_t* h, float dx, float dy) {
+    const int N = L::SIDE;
+    const float rise = 0.8f; // tan of the light elevation
+    uint64_t shadowed = 0;
+    for (int i = 0; i < N; ++i) {
+        L::forRow(i, 0, N - 1, [&](int j, int k){
+            float x = (float)i, y = (float)j, ref = (float)h[k] - 0.02f;
+            for (int s = 0; s < cfg::SHADOW_STEPS; ++s) {
+                x -= dx; y -= dy; ref += rise;
+                const int ii = (int)std::floor(x + 0.5f), jj = (int)std::floor(y + 0.5f);
+                if (ii < 0 || jj < 0 || ii >= N || jj >= N) break;
+                if ((float)h[L::index(ii, jj)] > ref) { ++shadowed; break; }
+            }
+        });
+    }
+    return shadowed;
+}
+
+// The renderer's per-quad shading (quadShadeC): two triangle normals from a 2x2 neighbourhood
+template <typename L>
+float normalPass(const int16_t* h) {
+    const int N = L::SIDE;
+    const float z = cfg::ELEV_STEP, lx = 0.f, ly = 0.780869f, lz = 0.624695f;
+    float acc = 0.f;
+    for (int i = 0; i + 1 < N; ++i) {
+        L::forRow(i, 0, N - 2, [&](int j, int k){
+            const float a = h[k] * z, b = h[L::index(i + 1, j)] * z;
+            const float c = h[L::index(i + 1, j + 1)] * z, d = h[L::index(i, j + 1)] * z;
+            // (B-A)x(C-A) and (C-A)x(D-A) on the unit grid
+            const float n1 = (lx * (a - b) + ly * (b - c) + lz) / std::sqrt((a - b) * (a - b) + (b - c) * (b - c) + 1.f);
+            const float n2 = (lx * (d - c) + ly * (a - d) + lz) / std::sqrt((d - c) * (d - c) + (a - d) * (a - d) + 1.f);
+            acc += 0.5f + 0.25f * (std::max(0.f, n1) + std::max(0.f, n2));
+        });
+    }
+    return acc;
+}
+
+template <typename L>
+void layoutRuns(const char* name, const std::vector<int16_t>& rowMajor) {
+    const std::vector<int16_t> h = toLayout<L>(rowMajor);
+    const uint64_t verts = (uint64_t)L::SIDE * L::SIDE;
+    const uint64_t n = verts * std::max<uint64_t>(1, (4u << 20) / verts); // per-vertex cost over whole passes
+    std::string label;
+    label = std::string(name) + " shadow -J";
+    report(label.c_str(), n, [&](uint64_t iters){
+        for (uint64_t p = 0; p < iters / verts; ++p) g_sink = shadowPass<L>(h.data(), 0.f, 1.f);
+    });
+    label = std::string(name) + " shadow diagonal";
+    report(label.c_str(), n, [&](uint64_t iters){
+        for (uint64_t p = 0; p < iters / verts; ++p) g_sink = shadowPass<L>(h.data(), 0.7071068f, 0.7071068f);
+    });
+    label = std::string(name) + " normals";
+    report(label.c_str(), n, [&](uint64_t iters){
+        float acc = 0.f;
+        for (uint64_t p = 0; p < iters / verts; ++p) acc += normalPass<L>(h.data());
+        g_sink = (uint64_t)acc;
+    });
+}
+
+template <int S>
+void benchLayoutSize() {
+    constexpr int N = S + 1;
+    std::printf("layout (CHUNK_SIZE %d, %dx%d vertices, cost per vertex)\n", S, N, N);
+    // Generator-like terrain (base FBM, same scale and elevation mapping)
+    std::vector<int16_t> rm((size_t)N * N);
+    const float f = cfg::NOISE_BASE_SCALE / (float)cfg::GRID;
+    for (int i = 0; i < N; ++i)
+        for (int j = 0; j < N; ++j) {
+            const float t = 0.5f * (noise::fbm(i * f, j * f, 1337u, 5, 2.f, 0.5f) + 1.f);
+            const float h = ((float)cfg::MIN_ELEV + t * (float)(cfg::MAX_ELEV - cfg::MIN_ELEV)) * cfg::HEIGHT_SCALE - cfg::SEA_OFFSET;
+            rm[(size_t)i * N + j] = (int16_t)std::clamp((int)std::lround(h * 4.f), cfg::MIN_ELEV, cfg::MAX_ELEV);
+        }
+    layoutRuns<layout::RowMajor<N>>("row-major", rm);
+    layoutRuns<layout::Tiled<N>>("tiled 8x8", rm);
+    layoutRuns<layout::Morton<N>>("Z-order", rm);
+}
+
+void benchLayout() {
+    benchLayoutSize<60>();
+    benchLayoutSize<128>();
+    benchLayoutSize<256>();
+}
+
+struct Bench { const char* name; void (*fn)(); };
+const Bench BENCHES[] = {
+    {"cache", benchCache},
+    {"tier", benchTier},
+    {"edit", benchEdit},
+    {"read", benchRead},
+    {"water", benchWater},
+    {"memory", benchMemory},
+    {"layout", benchLayout},
+    {"noise", benchNoise},
+    {"threads", benchThreads},
+    {"levels", benchLevels},
+    {"preview", benchPreview},
+};
+
+} // namespace
+
+int main(int argc, char** argv) {
+    for (const Bench& b : BENCHES) {
+        bool run = argc < 2;
+        for (int a = 1; a < argc; ++a) run = run || std::strcmp(argv[a], b.name) == 0;
+        if (run) b.fn();
+    }
+    return 0;
+}
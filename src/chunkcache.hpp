@@ -0,0 +1,146 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <utility>
+#include <vector>
+
+// Cache with CLOCK (second-chance) eviction and a growable slot capacity.
+// Values live in a slot array that never relocates (grow() appends), so references stay valid
+// until their entry is erased. Lookups go through a linear-probing index of {key, slot pointer}
+// pairs sized to stay under half full: a hit is one hash, usually one probe, then the slot
+// itself, with no allocation and no slot-array index arithmetic.
+template <typename K, typename V, typename Hash>
+class ClockCache {
+public:
+    explicit ClockCache(size_t capacity) { grow(capacity); }
+
+    size_t size() const { return _size; }
+    size_t capacity() const { return _slots.size(); }
+    bool full() const { return _size >= _slots.size(); }
+
+    // Lookup without touching the reference bit
+    V* find(const K& key) {
+        Slot* s = lookup(key);
+        return s ? &*s->value : nullptr;
+    }
+    // Lookup that marks the entry recently used
+    V* get(const K& key) {
+        Slot* s = lookup(key);
+        if (!s) return nullptr;
+        s->referenced = true;
+        return &*s->value;
+    }
+
+    // Raises the slot capacity (never shrinks); rebuilds the index when it would pass half full
+    void grow(size_t capacity) {
+        if (capacity <= _slots.size()) return;
+        _slots.resize(capacity);
+        size_t n = 1;
+        while (n < capacity * 2) n <<= 1;
+        if (n <= _index.size()) return;
+        std::vector<IndexEntry> old(n);
+        old.swap(_index);
+        _mask = n - 1;
+        for (const IndexEntry& e : old) {
+            if (!e.slot) continue;
+            size_t i = Hash{}(e.key) & _mask;
+            while (_index[i].slot) i = (i + 1) & _mask;
+            _index[i] = e;
+        }
+    }
+
+    // Inserts a key that is not resident. Requires !full(): evict or grow first.
+    V& insert(const K& key, V&& value) {
+        while (_slots[_hand].value) advance(); // free slot exists when !full()
+        Slot& slot = _slots[_hand];
+        slot.key = key;
+        slot.value.emplace(std::move(value));
+        slot.referenced = true;
+        size_t i = Hash{}(key) & _mask;
+        while (_index[i].slot) i = (i + 1) & _mask;
+        _index[i] = IndexEntry{key, &slot};
+        ++_size;
+        return *slot.value;
+    }
+
+    // Next eviction candidate among entries for which evictable(const V&) holds: sweeps the
+    // clock hand, clearing reference bits of the entries it passes (their second chance).
+    // Returns nullptr when no entry qualifies.
+    template <typename Pred>
+    const K* victim(Pred&& evictable) {
+        if (_size == 0) return nullptr;
+        // Two full turns: the first may only clear reference bits
+        for (size_t n = 0; n < 2 * _slots.size() + 1; ++n) {
+            Slot& slot = _slots[_hand];
+            if (slot.value && evictable(*slot.value)) {
+                if (!slot.referenced) return &slot.key;
+                slot.referenced = false;
+            }
+            advance();
+        }
+        return nullptr;
+    }
+    const K* victim() { return victim([](const V&){ return true; }); }
+
+    void erase(const K& key) {
+        size_t i = Hash{}(key) & _mask;
+        while (_index[i].slot && !(_index[i].key == key)) i = (i + 1) & _mask;
+        if (!_index[i].slot) return;
+        _index[i].slot->value.reset();
+        --_size;
+        // Backward-shift deletion keeps probe sequences tombstone-free
+        size_t hole = i;
+        for (size_t j = (i + 1) & _mask; _index[j].slot; j = (j + 1) & _mask) {
+            size_t home = Hash{}(_index[j].key) & _mask;
+            // Move j into the hole unless its home lies cyclically in (hole, j]
+            bool stays = (hole <= j) ? (hole < home && home <= j) : (hole < home || home <= j);
+            if (!stays) {
+                _index[hole] = _index[j];
+                hole = j;
+            }
+        }
+        _index[hole].slot = nullptr;
+    }
+
+    void clear() {
+        for (auto& s : _slots) s.value.reset();
+        for (auto& e : _index) e.slot = nullptr;
+        _size = 0;
+        _hand = 0;
+    }
+
+    // f(const K&, V&) for every resident entry
+    template <typename F>
+    void forEach(F&& f) {
+        for (auto& s : _slots) if (s.value) f(s.key, *s.value);
+    }
+
+private:
+    struct Slot {
+        K key{};
+        bool referenced = false;
+        std::optional<V> value;
+    };
+    struct IndexEntry {
+        K key{};
+        Slot* slot = nullptr; // nullptr = empty
+    };
+    std::deque<Slot> _slots; // deque: grow() appends without moving slots, so index pointers stay valid
+    std::vector<IndexEntry> _index;
+    size_t _mask = 0;
+    size_t _size = 0;
+    size_t _hand = 0;
+
+    Slot* lookup(const K& key) const {
+        size_t i = Hash{}(key) & _mask;
+        for (;;) {
+            const IndexEntry& e = _index[i];
+            if (!e.slot) return nullptr;
+            if (e.key == key) return e.slot;
+            i = (i + 1) & _mask;
+        }
+    }
+    void advance() { _hand = (_hand + 1 == _slots.size()) ? 0 : _hand + 1; }
+};
@@ -0,0 +1,46 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// Chunked world primitives
+struct ChunkKey {
+    int cx;
+    int cy;
+    bool operator==(const ChunkKey& o) const noexcept { return cx == o.cx && cy == o.cy; }
+};
+
+struct ChunkKeyHash {
+    size_t operator()(const ChunkKey& k) const noexcept {
+        // 64-bit mix
+        uint64_t x = static_cast<uint64_t>(static_cast<uint32_t>(k.cx));
+        uint64_t y = static_cast<uint64_t>(static_cast<uint32_t>(k.cy));
+        uint64_t h = x * 0x9E3779B185EBCA87ULL ^ (y + 0xC2B2AE3D27D4EB4FULL + (x<<6) + (x>>2));
+        return static_cast<size_t>(h ^ (h >> 32));
+    }
+};
+
+// A chunk of one of the worlds kept in cache (world: index assigned by ChunkManager)
+struct WorldChunkKey {
+    ChunkKey chunk;
+    uint32_t world;
+    bool operator==(const WorldChunkKey& o) const noexcept { return chunk == o.chunk && world == o.world; }
+};
+
+struct WorldChunkKeyHash {
+    size_t operator()(const WorldChunkKey& k) const noexcept {
+        return ChunkKeyHash{}(k.chunk) ^ (static_cast<size_t>(k.world) * 0x9E3779B97F4A7C15ULL);
+    }
+};
+
+// A cached world's chunk at one coarse resolution level (ChunkManager::levelHeights)
+struct LevelChunkKey {
+    WorldChunkKey key;
+    int level;
+    bool operator==(const LevelChunkKey& o) const noexcept { return key == o.key && level == o.level; }
+};
+
+struct LevelChunkKeyHash {
+    size_t operator()(const LevelChunkKey& k) const noexcept {
+        return WorldChunkKeyHash{}(k.key) ^ (static_cast<size_t>(k.level) * 0xC2B2AE3D27D4EB4FULL);
+    }
+};
@@ -0,0 +1,119 @@
+#include "chunkoverrides.hpp"
+#include <algorithm>
+
+const ChunkOverrides::Pair* ChunkOverrides::lowerBound(int k) const {
+    return std::lower_bound(_sparse.data(), _sparse.data() + _sparse.size(), k,
+                            [](const Pair& p, int key){ return (int)p.k < key; });
+}
+
+bool ChunkOverrides::contains(int k) const {
+    if (!_bits.empty()) return (_bits[(size_t)k >> 6] >> (k & 63)) & 1u;
+    const Pair* p = lowerBound(k);
+    return p != _sparse.data() + _sparse.size() && p->k == k;
+}
+
+int ChunkOverrides::get(int k, int fallback) const {
+    if (!_bits.empty()) return ((_bits[(size_t)k >> 6] >> (k & 63)) & 1u) ? _values[k] : fallback;
+    const Pair* p = lowerBound(k);
+    return (p != _sparse.data() + _sparse.size() && p->k == k) ? p->v : fallback;
+}
+
+void ChunkOverrides::set(int k, int v) {
+    if (!_bits.empty()) {
+        uint64_t& w = _bits[(size_t)k >> 6];
+        const uint64_t bit = uint64_t(1) << (k & 63);
+        if (!(w & bit)) { w |= bit; ++_count; }
+        _values[k] = (int16_t)v;
+        return;
+    }
+    auto it = _sparse.begin() + (lowerBound(k) - _sparse.data());
+    if (it != _sparse.end() && it->k == k) { it->v = (int16_t)v; return; }
+    if (_count == SPARSE_MAX) {
+        densify();
+        set(k, v);
+        return;
+    }
+    _sparse.insert(it, Pair{(uint16_t)k, (int16_t)v});
+    ++_count;
+}
+
+void ChunkOverrides::setRun(int k0, int n, const int* vals, const uint8_t* mask) {
+    if (_bits.empty()) {
+        // Merge the run with the pairs already inside [k0, k0+n): one search, one splice
+        const size_t lo = (size_t)(lowerBound(k0) - _sparse.data());
+        size_t hi = lo;
+        thread_local std::vector<Pair> run;
+        run.clear();
+        for (int t = 0; t < n; ++t) {
+            const int k = k0 + t;
+            const bool hit = hi < _sparse.size() && _sparse[hi].k == k;
+            if (mask && !mask[t]) {
+                if (hit) run.push_back(_sparse[hi++]);
+                continue;
+            }
+            run.push_back(Pair{(uint16_t)k, (int16_t)vals[t]});
+            if (hit) ++hi;
+        }
+        const size_t count = _count - (hi - lo) + run.size();
+        if (count <= SPARSE_MAX) {
+            if (run.size() == hi - lo) {
+                std::copy(run.begin(), run.end(), _sparse.begin() + (ptrdiff_t)lo);
+            } else {
+                _sparse.erase(_sparse.begin() + (ptrdiff_t)lo, _sparse.begin() + (ptrdiff_t)hi);
+                _sparse.insert(_sparse.begin() + (ptrdiff_t)lo, run.begin(), run.end());
+            }
+            _count = count;
+            return;
+        }
+        densify();
+    }
+    for (int t = 0; t < n; ++t) {
+        if (mask && !mask[t]) continue;
+        const int k = k0 + t;
+        uint64_t& w = _bits[(size_t)k >> 6];
+        const uint64_t bit = uint64_t(1) << (k & 63);
+        if (!(w & bit)) { w |= bit; ++_count; }
+        _values[k] = (int16_t)vals[t];
+    }
+}
+
+void ChunkOverrides::clear() {
+    std::vector<Pair>().swap(_sparse);
+    std::vector<uint64_t>().swap(_bits);
+    std::vector<int16_t>().swap(_values);
+    _count = 0;
+}
+
+bool ChunkOverrides::any(int k0, int n) const {
+    if (_count == 0 || n <= 0) return false;
+    if (_bits.empty()) {
+        const Pair* p = lowerBound(k0);
+        return p != _sparse.data() + _sparse.size() && p->k < k0 + n;
+    }
+    for (int k = k0; k < k0 + n; ++k)
+        if ((_bits[(size_t)k >> 6] >> (k & 63)) & 1u) return true;
+    return false;
+}
+
+void ChunkOverrides::read(int k0, int n, int* out) const {
+    if (_count == 0) return;
+    if (_bits.empty()) {
+        for (const Pair* p = lowerBound(k0), *e = _sparse.data() + _sparse.size(); p != e && p->k < k0 + n; ++p)
+            out[p->k - k0] = p->v;
+        return;
+    }
+    for (int t = 0; t < n; ++t) {
+        const int k = k0 + t;
+        if ((_bits[(size_t)k >> 6] >> (k & 63)) & 1u) out[t] = _values[k];
+    }
+}
+
+void ChunkOverrides::densify() {
+    _bits.assign(((size_t)VERTS + 63) / 64, 0);
+    _values.assign((size_t)VERTS, 0);
+    for (const Pair& p : _sparse) {
+        _bits[p.k >> 6] |= uint64_t(1) << (p.k & 63);
+        _values[p.k] = p.v;
+    }
+    std::vector<Pair>().swap(_sparse);
+}
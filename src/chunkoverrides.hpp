@@ -0,0 +1,72 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "config.hpp"
+
+// Override layer of one chunk: which vertices the user edited, and their values.
+// Few edits: a sorted array of {vertex, value} pairs (4 bytes per edit, empty when unedited).
+// Past SPARSE_MAX edits: a bitset plus a dense int16 value array (~2.1 bytes per vertex).
+class ChunkOverrides {
+public:
+    static constexpr int VERTS = (cfg::CHUNK_SIZE + 1) * (cfg::CHUNK_SIZE + 1);
+    static constexpr size_t SPARSE_MAX = VERTS / 8;
+    static_assert(VERTS <= 65536, "vertex indices must fit in uint16_t");
+
+    size_t count() const { return _count; }
+    bool empty() const { return _count == 0; }
+    bool contains(int k) const;
+    // Value of vertex k, or fallback when it is not edited
+    int get(int k, int fallback = 0) const;
+    void set(int k, int v);
+    // set(k0+t, vals[t]) for t in [0, n) where mask is null or mask[t] != 0
+    void setRun(int k0, int n, const int* vals, const uint8_t* mask);
+    // Forgets every edit and frees the storage
+    void clear();
+
+    // Dense mode only (else null): value per vertex, 0 where not edited
+    const int16_t* dense() const { return _bits.empty() ? nullptr : _values.data(); }
+
+    // True if any vertex in [k0, k0+n) is edited
+    bool any(int k0, int n) const;
+    // out[t] = value of vertex k0+t if edited, else left untouched
+    void read(int k0, int n, int* out) const;
+    // f(k, v) for every edited vertex, in increasing k
+    template <typename F>
+    void forEach(F&& f) const {
+        if (_bits.empty()) {
+            for (const Pair& p : _sparse) f((int)p.k, (int)p.v);
+            return;
+        }
+        for (size_t w = 0; w < _bits.size(); ++w) {
+            for (uint64_t b = _bits[w]; b; b &= b - 1) {
+                int k = (int)(w * 64) + ctz(b);
+                f(k, (int)_values[k]);
+            }
+        }
+    }
+
+    // Heap memory held
+    size_t bytes() const {
+        return _sparse.capacity() * sizeof(Pair) + _bits.capacity() * sizeof(uint64_t) + _values.capacity() * sizeof(int16_t);
+    }
+
+private:
+    struct Pair { uint16_t k; int16_t v; };
+    std::vector<Pair> _sparse;     // sorted by k; used while _bits is empty
+    std::vector<uint64_t> _bits;   // dense mode: bit k set <=> vertex k edited
+    std::vector<int16_t> _values;  // dense mode: value per vertex
+    size_t _count = 0;
+
+    static int ctz(uint64_t b) {
+#if defined(__GNUC__)
+        return __builtin_ctzll(b);
+#else
+        int n = 0;
+        while (!(b & 1u)) { b >>= 1; ++n; }
+        return n;
+#endif
+    }
+    const Pair* lowerBound(int k) const;
+    void densify();
+};
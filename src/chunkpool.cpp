@@ -0,0 +1,65 @@
+#include "chunkpool.hpp"
+#include <algorithm>
+#include <atomic>
+
+ChunkPool::~ChunkPool() {
+    for (int16_t* b : _free) deallocate(b);
+}
+
+int16_t* ChunkPool::allocate() {
+    return new int16_t[VERTS](); // value-initialized: flat at sea level
+}
+
+const int16_t* ChunkPool::uniform(int v) {
+    static std::atomic<const int16_t*> blocks[cfg::MAX_ELEV - cfg::MIN_ELEV + 1];
+    static std::mutex mtx;
+    std::atomic<const int16_t*>& slot = blocks[v - cfg::MIN_ELEV];
+    if (const int16_t* b = slot.load(std::memory_order_acquire)) return b;
+    std::lock_guard<std::mutex> lk(mtx);
+    if (const int16_t* b = slot.load(std::memory_order_relaxed)) return b;
+    int16_t* b = new int16_t[VERTS];
+    std::fill(b, b + VERTS, (int16_t)v);
+    slot.store(b, std::memory_order_release);
+    return b;
+}
+
+int16_t* ChunkPool::acquire() {
+    int16_t* block = nullptr;
+    {
+        std::lock_guard<std::mutex> lk(_mtx);
+        if (!_free.empty()) {
+            block = _free.back();
+            _free.pop_back();
+            ++_stats.hits;
+        } else {
+            ++_stats.misses;
+        }
+    }
+    return block ? block : allocate();
+}
+
+void ChunkPool::release(int16_t* block) {
+    if (!block) return;
+    {
+        std::lock_guard<std::mutex> lk(_mtx);
+        if (_free.size() < _maxFree) { _free.push_back(block); return; }
+    }
+    deallocate(block);
+}
+
+void ChunkPool::setMaxFree(size_t n) {
+    std::vector<int16_t*> drop;
+    {
+        std::lock_guard<std::mutex> lk(_mtx);
+        _maxFree = n;
+        while (_free.size() > n) { drop.push_back(_free.back()); _free.pop_back(); }
+    }
+    for (int16_t* b : drop) deallocate(b);
+}
+
+ChunkPool::Stats ChunkPool::stats() {
+    std::lock_guard<std::mutex> lk(_mtx);
+    Stats s = _stats;
+    s.free = _free.size();
+    return s;
+}
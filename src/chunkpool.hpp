@@ -0,0 +1,48 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+#include "config.hpp"
+
+// Recycles chunk height blocks: int16_t heights[VERTS] per chunk (elevations fit in
+// cfg::MIN_ELEV..cfg::MAX_ELEV). Overrides are sparse and live with the chunk, not here.
+// Thread-safe: workers acquire while generating, the render thread releases on eviction.
+class ChunkPool {
+public:
+    static constexpr int VERTS = (cfg::CHUNK_SIZE + 1) * (cfg::CHUNK_SIZE + 1);
+    static constexpr size_t BLOCK_BYTES = VERTS * sizeof(int16_t);
+    static_assert(cfg::MIN_ELEV >= INT16_MIN && cfg::MAX_ELEV <= INT16_MAX, "elevations must fit in int16_t");
+
+    struct Stats {
+        uint64_t hits = 0;   // blocks reused from the free list
+        uint64_t misses = 0; // blocks freshly allocated
+        size_t free = 0;     // blocks currently waiting for reuse
+    };
+
+    ChunkPool() = default;
+    ~ChunkPool();
+    ChunkPool(const ChunkPool&) = delete;
+    ChunkPool& operator=(const ChunkPool&) = delete;
+
+    // Heights are left unspecified for the generator to fill
+    int16_t* acquire();
+    void release(int16_t* block);
+    Stats stats();
+    // Spare blocks beyond this are freed on release (and right away when lowered)
+    void setMaxFree(size_t n);
+
+    // Standalone blocks (no pool): fully zeroed / freed
+    static int16_t* allocate();
+    static void deallocate(int16_t* block) { delete[] block; }
+
+    // Shared read-only block with every height at v (cfg::MIN_ELEV..cfg::MAX_ELEV), created on
+    // first use and kept for the whole run. Flat chunks point here instead of owning a block.
+    static const int16_t* uniform(int v);
+
+private:
+    std::mutex _mtx;
+    std::vector<int16_t*> _free;
+    size_t _maxFree = (size_t)cfg::CHUNK_POOL_MAX_FREE;
+    Stats _stats;
+};
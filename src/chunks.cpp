@@ -1,129 +1,632 @@
 #include "chunks.hpp"
+#include "chunkstore.hpp"
 #include "noise.hpp"
 #include <algorithm>
+#include <climits>
 #include <cmath>
-#include <filesystem>
-#include <fstream>
+#include <cstdlib>
 #include <sstream>
 
 static inline int clampi(int v, int lo, int hi) { return std::max(lo, std::min(hi, v)); }
 static inline int floorDiv(int a, int b) { return (a >= 0) ? (a / b) : ((a - (b - 1)) / b); }
 
 using std::string;
-namespace fs = std::filesystem;
+
+ChunkManager::~ChunkManager() {
+    clear();
+    _journal.waitCompaction();
+    _flusher.flush();
+}
 
 void ChunkManager::clear() {
-    // Save any dirty chunks to disk, then clear structures
-    for (auto& kv : _cache) {
-        Entry& e = kv.second;
-        if (e.dirty) {
-            saveOverrides(e.ch, kv.first.cx, kv.first.cy);
-            e.dirty = false;
+    // Resident chunks hold no unsaved state once the pending batch is in the journal
+    _journal.commit();
+    dropCache();
+    dropRequests();
+}
+
+void ChunkManager::resetOverrides() {
+    // Workers may still be reading override files of this world, and queued
+    // writes would recreate the directory after it is deleted
+    dropRequests();
+    waitWorkersIdle();
+    _journal.discard();
+    _flusher.flush();
+
+    // Delete persisted region files for current seed/continents
+    _regions.dropDir(_world.dir);
+
+    // Drop the cached chunks saved there (their edits were dropped with the journal)
+    dropWorlds(_world.dir, UINT32_MAX);
+    _worldEdited = false;
+}
+
+void ChunkManager::selectWorld(const World& sel) {
+    World w = sel;
+    w.dir = worldDir(w);
+    // Edits made here went to this directory: other worlds saved there hold stale overrides
+    if (_worldEdited) dropWorlds(_world.dir, _worldId);
+    _worldEdited = false;
+    uint32_t id = 0;
+    while (id < _worlds.size() && !(_worlds[id].mode == w.mode && _worlds[id].seed == w.seed &&
+                                    _worlds[id].continents == w.continents)) ++id;
+    if (id == _worlds.size()) _worlds.push_back(w);
+    _worldId = id;
+    _world = w;
+    // Prefetches of the previous world are plain cached chunks now (they hold no prefetch budget)
+    _cache.forEach([](const WorldChunkKey&, Entry& e){ e.prefetched = false; });
+    _prefetchResident = 0;
+    dropRequests();
+    _journal.open(_world.dir); // commits the previous world's pending edits first
+}
+
+void ChunkManager::dropWorlds(const std::string& dir, uint32_t except) {
+    std::vector<WorldChunkKey> keys;
+    _cache.forEach([&](const WorldChunkKey& k, Entry&){
+        if (k.world != except && _worlds[k.world].dir == dir) keys.push_back(k);
+    });
+    for (const WorldChunkKey& k : keys) erase(k);
+    for (uint32_t id = 0; id < _worlds.size(); ++id)
+        if (id != except && _worlds[id].dir == dir) _tier.eraseWorld(id);
+    eraseLevelWorlds(dir, except);
+}
+
+ChunkManager::Entry& ChunkManager::insertEntry(const ChunkKey& key, Chunk&& ch) {
+    _tier.erase(wk(key)); // the resident copy is the only one
+    size_t bytes = entryBytes(ch);
+    makeRoom(bytes); // over budget is fine when the visible set needs it
+    if (_cache.full()) _cache.grow(_cache.capacity() * 2);
+    Entry e(std::move(ch));
+    e.lastFrame = _frame;
+    e.bytes = bytes;
+    e.serial = _nextSerial++;
+    _cacheBytes += bytes;
+    _cacheHighWater = std::max(_cacheHighWater, _cacheBytes);
+    return _cache.insert(wk(key), std::move(e));
+}
+
+bool ChunkManager::makeRoom(size_t bytes) {
+    const uint32_t frame = _frame;
+    auto evictable = [frame](const Entry& e){ return e.pins == 0 && e.lastFrame + 1 < frame; };
+    while (_cacheBytes + bytes > _cacheBudget) {
+        const WorldChunkKey* victim = _cache.victim(evictable);
+        if (!victim) return false;
+        evict(*victim);
+    }
+    return true;
+}
+
+void ChunkManager::evict(const WorldChunkKey& key) {
+    if (Entry* e = _cache.find(key)) _tier.put(key, e->ch);
+    erase(key);
+}
+
+void ChunkManager::erase(const WorldChunkKey& key) {
+    Entry* e = _cache.find(key);
+    if (!e) return;
+    if (e->prefetched) --_prefetchResident;
+    _cacheBytes -= e->bytes;
+    _cache.erase(key);
+}
+
+void ChunkManager::setCacheBudget(size_t bytes) {
+    _cacheBudget = bytes;
+    makeRoom(0);
+}
+
+void Chunk::adoptHeights(Chunk&& g) {
+    _heights.release(_pool);
+    _heights.take(g._heights);
+    if (_overrides.empty()) return;
+    int16_t* h = _heights.mut(_pool);
+    _overrides.forEach([h](int k, int v){ h[k] = (int16_t)v; });
+}
+
+void Chunk::setOverrides(int k0, int n, const int* vals, const uint8_t* mask) {
+    _overrides.setRun(k0, n, vals, mask);
+    // Dense overrides double as the water view
+    if (_overrides.dense()) _water.release(_pool);
+    int16_t* w = _overrides.dense() ? nullptr : _water.mut(_pool);
+    int16_t* h = _heights.present() ? _heights.mut(_pool) : nullptr;
+    for (int t = 0; t < n; ++t) {
+        if (mask && !mask[t]) continue;
+        if (w) w[k0 + t] = (int16_t)vals[t];
+        if (h) h[k0 + t] = (int16_t)vals[t];
+    }
+}
+
+ChunkManager::Entry* ChunkManager::touch(const ChunkKey& key) {
+    Entry* e = _cache.get(wk(key));
+    if (!e) return nullptr;
+    e->lastFrame = _frame;
+    if (e->prefetched) { e->prefetched = false; --_prefetchResident; }
+    return e;
+}
+
+ChunkManager::Entry& ChunkManager::acquire(const ChunkKey& key, bool heights) {
+    Entry* e = touch(key);
+    if (!e) {
+        Chunk ch(_chunkPool);
+        if (!_tier.take(wk(key), ch)) {
+            if (heights) {
+                // Build synchronously; any background request for it becomes stale
+                cancelRequest(key);
+                generateChunk(ch, key.cx, key.cy, _world);
+            }
+            // Load persisted overrides (region data + journal)
+            loadOverrides(ch, key.cx, key.cy, _world);
         }
+        e = &insertEntry(key, std::move(ch));
     }
-    _cache.clear();
-    _lru.clear();
+    if (heights && !e->ch.materialized()) materialize(key, *e);
+    return *e;
 }
 
-void ChunkManager::resetOverrides() {
-    // Delete persisted overrides directory for current seed/continents
-    std::ostringstream oss;
-    oss << "maps/seed_" << _seed;
-    if (_continents) oss << "_cont";
-    fs::path dir(oss.str());
-    std::error_code ec;
-    fs::remove_all(dir, ec); // ignore errors
+ChunkManager::Entry* ChunkManager::tryAcquire(const ChunkKey& key, bool heights) {
+    Entry* e = touch(key);
+    if (!e && heights) {
+        std::lock_guard<std::mutex> lk(_reqMtx);
+        // A chunk needed now is no longer a prefetch (keeps it from being cancelled or dropped)
+        auto q = _queued.find(key);
+        if (q != _queued.end()) { q->second.prefetch = false; return nullptr; }
+        auto f = _inflight.find(key);
+        if (f != _inflight.end()) { f->second.prefetch = false; return nullptr; }
+    }
+    if (!e) {
+        // Recently evicted: decoding beats regenerating, no need for a worker
+        Chunk ch(_chunkPool);
+        if (_tier.take(wk(key), ch)) {
+            e = &insertEntry(key, std::move(ch));
+        } else if (!heights) {
+            // Edits only: no noise to run, loading them does not need a worker
+            loadOverrides(ch, key.cx, key.cy, _world);
+            e = &insertEntry(key, std::move(ch));
+        }
+    }
+    if (e && (!heights || e->ch.materialized())) return e;
+    {
+        std::lock_guard<std::mutex> lk(_reqMtx);
+        auto q = _queued.find(key);
+        if (q != _queued.end()) { q->second.prefetch = false; return nullptr; }
+        auto f = _inflight.find(key);
+        if (f != _inflight.end()) { f->second.prefetch = false; return nullptr; }
+        _queued.emplace(key, Request{_nextTicket++, false, nullptr});
+    }
+    // One pool task per request; each task runs whichever request is most urgent when it starts
+    _pool.submit([this]{ runNextRequest(); });
+    return nullptr;
+}
+
+void ChunkManager::materialize(const ChunkKey& key, Entry& e) {
+    cancelRequest(key);
+    Chunk g(_chunkPool);
+    generateChunk(g, key.cx, key.cy, _world);
+    e.ch.adoptHeights(std::move(g));
+    reaccount(e);
+}
+
+void ChunkManager::reaccount(Entry& e) {
+    const size_t bytes = entryBytes(e.ch);
+    _cacheBytes = _cacheBytes - e.bytes + bytes;
+    _cacheHighWater = std::max(_cacheHighWater, _cacheBytes);
+    e.bytes = bytes;
+}
+
+int ChunkManager::generateChunks(const std::vector<ChunkKey>& keys) {
+    // Serve what needs no noise first; the rest is generated in parallel
+    std::vector<ChunkKey> todo;
+    std::vector<uint8_t> fresh; // not resident: its overrides are loaded with the heights
+    std::unordered_map<ChunkKey, bool, ChunkKeyHash> seen;
+    seen.reserve(keys.size());
+    for (const ChunkKey& k : keys) {
+        if (!seen.emplace(k, true).second) continue;
+        Entry* e = touch(k);
+        if (!e) {
+            Chunk ch(_chunkPool);
+            if (_tier.take(wk(k), ch)) e = &insertEntry(k, std::move(ch));
+        }
+        if (e && e->ch.materialized()) continue;
+        cancelRequest(k); // built here; a background result would be stale
+        todo.push_back(k);
+        fresh.push_back(e ? 0 : 1);
+    }
+    std::vector<Chunk> built;
+    built.reserve(todo.size());
+    for (size_t t = 0; t < todo.size(); ++t) built.emplace_back(_chunkPool);
+    const World w = _world;
+    _pool.parallelFor((int)todo.size(), [&](int t){
+        generateChunk(built[(size_t)t], todo[(size_t)t].cx, todo[(size_t)t].cy, w);
+        if (fresh[(size_t)t]) loadOverrides(built[(size_t)t], todo[(size_t)t].cx, todo[(size_t)t].cy, w);
+    });
+    for (size_t t = 0; t < todo.size(); ++t) {
+        const ChunkKey& k = todo[t];
+        if (Entry* e = touch(k)) {
+            e->ch.adoptHeights(std::move(built[t]));
+            reaccount(*e);
+            continue;
+        }
+        // Evicted meanwhile by the batch itself (it held no heights): rebuild its edits
+        if (!fresh[t]) loadOverrides(built[t], k.cx, k.cy, w);
+        insertEntry(k, std::move(built[t]));
+    }
+    return (int)todo.size();
+}
 
-    // Clear in-memory cache WITHOUT saving dirty chunks
-    _cache.clear();
-    _lru.clear();
+const Chunk& ChunkManager::getChunk(int cx, int cy, Layer need) {
+    return acquire(ChunkKey{cx, cy}, need != Layer::Overrides).ch;
 }
 
-const Chunk& ChunkManager::getChunk(int cx, int cy) {
+const Chunk* ChunkManager::tryGetChunk(int cx, int cy, Layer need) {
+    Entry* e = tryAcquire(ChunkKey{cx, cy}, need != Layer::Overrides);
+    return e ? &e->ch : nullptr;
+}
+
+ChunkManager::Pin ChunkManager::pin(int cx, int cy, Layer need) {
     ChunkKey key{cx, cy};
-    auto it = _cache.find(key);
-    if (it != _cache.end()) {
-        // Move to front in LRU
-        _lru.erase(it->second.it);
-        _lru.push_front(key);
-        it->second.it = _lru.begin();
-        return it->second.ch;
-    }
-    // Miss: create and generate
-    Entry e{};
-    generateChunk(e.ch, cx, cy);
-    // Load persisted overrides if any
-    loadOverrides(e.ch, cx, cy);
-    _lru.push_front(key);
-    e.it = _lru.begin();
-    _cache.emplace(key, std::move(e));
-    // Evict if needed
-    while (_cache.size() > static_cast<size_t>(cfg::MAX_CACHED_CHUNKS)) {
-        const ChunkKey& oldKey = _lru.back();
-        auto itold = _cache.find(oldKey);
-        if (itold != _cache.end()) {
-            if (itold->second.dirty) {
-                saveOverrides(itold->second.ch, itold->first.cx, itold->first.cy);
-                itold->second.dirty = false;
+    return makePin(key, acquire(key, need != Layer::Overrides));
+}
+
+ChunkManager::Pin ChunkManager::tryPin(int cx, int cy, Layer need) {
+    ChunkKey key{cx, cy};
+    Entry* e = tryAcquire(key, need != Layer::Overrides);
+    return e ? makePin(key, *e) : Pin();
+}
+
+ChunkManager::Pin ChunkManager::makePin(const ChunkKey& key, Entry& e) {
+    ++e.pins;
+    return Pin(this, wk(key), &e.ch, e.serial);
+}
+
+void ChunkManager::unpin(const WorldChunkKey& key, uint64_t serial) {
+    // Dropped since (clear, resetOverrides): the entry is gone or a newer one holds the key
+    Entry* e = _cache.find(key);
+    if (e && e->serial == serial) --e->pins;
+}
+
+void ChunkManager::Pin::reset() {
+    if (_mgr) _mgr->unpin(_key, _serial);
+    _mgr = nullptr;
+    _ch = nullptr;
+}
+
+const int16_t* ChunkManager::halo(const Pin& p) {
+    if (cfg::SHADOW_HALO <= 0 || !p || p._key.world != _worldId) return nullptr;
+    Entry* e = _cache.find(p._key);
+    if (!e || e->serial != p._serial) return nullptr;
+    if (const int16_t* h = e->ch.halo()) return h;
+    const int S = cfg::CHUNK_SIZE;
+    const int cx = p._key.chunk.cx, cy = p._key.chunk.cy;
+    const int Jh = cy * S - cfg::SHADOW_HALO; // first halo column (world)
+    bool ready = true;
+    for (int ny = floorDiv(Jh, S); ny < cy; ++ny) ready = tryGetChunk(cx, ny) && ready;
+    if (!ready) return nullptr;
+    // Each halo vertex comes from the chunk that owns it (local index < S)
+    int16_t* out = e->ch.writableHalo();
+    for (int ny = floorDiv(Jh, S); ny < cy; ++ny) {
+        const int16_t* h = tryGetChunk(cx, ny)->heightData();
+        const int ja = std::max(Jh, ny * S), jb = ny * S + S - 1;
+        for (int i = 0; i <= S; ++i)
+            std::copy(h + Chunk::idx(i, ja - ny * S), h + Chunk::idx(i, jb - ny * S) + 1,
+                      out + Chunk::haloIdx(i, ja - cy * S));
+    }
+    reaccount(*e);
+    return out;
+}
+
+void ChunkManager::setViewFocus(int ccx, int ccy, int radius) {
+    std::lock_guard<std::mutex> lk(_reqMtx);
+    _focusCx = ccx; _focusCy = ccy;
+    // Chunks before the view along J feed the shadow halos of the visible ones
+    const int haloChunks = (cfg::SHADOW_HALO + cfg::CHUNK_SIZE - 1) / cfg::CHUNK_SIZE;
+    for (auto it = _queued.begin(); it != _queued.end(); ) {
+        const int dx = std::abs(it->first.cx - ccx), dy = it->first.cy - ccy;
+        const bool far = dx > radius + 1 || dy > radius + 1 || dy < -(radius + 1 + haloChunks);
+        // Prefetches lie outside the view on purpose; prefetch() manages their lifetime
+        if (far && !it->second.prefetch) { _previews.erase(it->first); it = _queued.erase(it); }
+        else ++it;
+    }
+}
+
+void ChunkManager::prefetch(const std::vector<ChunkKey>& keys) {
+    std::unordered_map<ChunkKey, bool, ChunkKeyHash> wanted;
+    wanted.reserve(keys.size());
+    for (const auto& k : keys) wanted[k] = true;
+    int submitted = 0;
+    {
+        std::lock_guard<std::mutex> lk(_reqMtx);
+        int outstanding = _prefetchResident;
+        for (auto it = _queued.begin(); it != _queued.end(); ) {
+            if (it->second.prefetch && !wanted.count(it->first)) { it = _queued.erase(it); continue; }
+            if (it->second.prefetch) ++outstanding;
+            ++it;
+        }
+        for (const auto& kv : _inflight) if (kv.second.prefetch) ++outstanding;
+        for (const auto& k : keys) {
+            if (outstanding >= _prefetchBudget) break;
+            if (_cache.find(wk(k)) || _tier.contains(wk(k)) || _queued.count(k) || _inflight.count(k)) continue;
+            _queued.emplace(k, Request{_nextTicket++, true, nullptr});
+            ++outstanding;
+            ++submitted;
+        }
+    }
+    for (int n = 0; n < submitted; ++n) _pool.submit([this]{ runNextRequest(); });
+}
+
+void ChunkManager::pumpCompleted() {
+    std::vector<Result> done;
+    std::vector<Preview> previews;
+    {
+        std::lock_guard<std::mutex> lk(_reqMtx);
+        done.swap(_done);
+        previews.swap(_previewsDone);
+        // Only previews of requests still pending (not cancelled or served since)
+        auto pending = [&](const ChunkKey& k, uint64_t ticket){
+            auto q = _queued.find(k);
+            if (q != _queued.end()) return q->second.ticket == ticket;
+            auto f = _inflight.find(k);
+            return f != _inflight.end() && f->second.ticket == ticket;
+        };
+        previews.erase(std::remove_if(previews.begin(), previews.end(),
+                                      [&](const Preview& p){ return !pending(p.key, p.ticket); }), previews.end());
+    }
+    ++_frame;
+    for (auto& p : previews) _previews[p.key] = std::move(p.heights);
+    for (auto& r : done) {
+        _previews.erase(r.key);
+        if (Entry* e = _cache.find(wk(r.key))) {
+            // Loaded meanwhile: synchronously, or without heights (then these complete it)
+            if (!e->ch.materialized()) {
+                e->ch.adoptHeights(std::move(r.ch));
+                reaccount(*e);
+            }
+            continue;
+        }
+        if (r.req.prefetch) {
+            // Never make room for a prefetch by evicting something drawn last frame
+            if (!makeRoom(entryBytes(r.ch))) continue;
+            Entry& e = insertEntry(r.key, std::move(r.ch));
+            e.prefetched = true;
+            e.lastFrame = 0;
+            ++_prefetchResident;
+        } else {
+            insertEntry(r.key, std::move(r.ch));
+        }
+    }
+    _journal.commitIfOlderThan(cfg::JOURNAL_COMMIT_SEC);
+}
+
+void ChunkManager::runNextRequest() {
+    ChunkKey key{0, 0};
+    uint64_t ticket = 0;
+    World w;
+    std::shared_ptr<Staged> staged;
+    bool preview = false;
+    {
+        std::lock_guard<std::mutex> lk(_reqMtx);
+        if (_queued.empty()) return; // cancelled or already served by another task
+        auto best = _queued.begin();
+        int bestD = 1 << 30;
+        for (auto it = _queued.begin(); it != _queued.end(); ++it) {
+            int d = std::max(std::abs(it->first.cx - _focusCx), std::abs(it->first.cy - _focusCy));
+            if (it->second.prefetch) d += 1 << 16; // visible requests always go first
+            else if (it->second.staged) d += 1 << 12; // then previews before refinements
+            if (d < bestD) { bestD = d; best = it; }
+        }
+        key = best->first;
+        ticket = best->second.ticket;
+        staged = best->second.staged;
+        w = _jobWorld;
+        // Prefetches are not on screen yet: no preview, one pass
+        preview = !staged && !best->second.prefetch && w.mode == Mode::Procedural && cfg::CHUNK_PREVIEW_OCTAVES > 0;
+        _inflight[key] = best->second;
+        _queued.erase(best);
+        ++_running;
+    }
+    if (preview) {
+        auto s = std::make_shared<Staged>(_chunkPool);
+        loadOverrides(s->ch, key.cx, key.cy, w);
+        std::vector<int16_t> heights(ChunkPool::VERTS);
+        previewChunk(*s, heights.data(), key.cx, key.cy, w);
+        bool requeued = false;
+        {
+            std::lock_guard<std::mutex> lk(_reqMtx);
+            auto it = _inflight.find(key);
+            if (it != _inflight.end() && it->second.ticket == ticket) {
+                _previewsDone.push_back(Preview{key, ticket, std::move(heights)});
+                it->second.staged = std::move(s);
+                _queued.emplace(key, std::move(it->second));
+                _inflight.erase(it);
+                requeued = true;
             }
-            _cache.erase(itold);
+            --_running;
+        }
+        _idleCv.notify_all();
+        if (requeued) _pool.submit([this]{ runNextRequest(); });
+        return;
+    }
+    Chunk ch(_chunkPool);
+    if (staged) {
+        refineChunk(*staged, ch, key.cx, key.cy, w);
+        staged->ch.adoptHeights(std::move(ch));
+        ch = std::move(staged->ch);
+    } else {
+        generateChunk(ch, key.cx, key.cy, w);
+        loadOverrides(ch, key.cx, key.cy, w);
+    }
+    {
+        std::lock_guard<std::mutex> lk(_reqMtx);
+        auto it = _inflight.find(key);
+        if (it != _inflight.end() && it->second.ticket == ticket) {
+            _done.push_back(Result{key, it->second, std::move(ch)});
+            _inflight.erase(it);
         }
-        _lru.pop_back();
+        --_running;
     }
-    return _cache.find(key)->second.ch;
+    _idleCv.notify_all();
 }
 
-void ChunkManager::generateChunk(Chunk& out, int cx, int cy) {
+void ChunkManager::cancelRequest(const ChunkKey& key) {
+    _previews.erase(key);
+    std::lock_guard<std::mutex> lk(_reqMtx);
+    _queued.erase(key);
+    _inflight.erase(key); // result will be dropped on completion
+}
+
+void ChunkManager::dropRequests() {
+    _previews.clear();
+    std::lock_guard<std::mutex> lk(_reqMtx);
+    _queued.clear();
+    _inflight.clear();
+    _done.clear();
+    _previewsDone.clear();
+    _jobWorld = _world;
+}
+
+void ChunkManager::waitWorkersIdle() {
+    std::unique_lock<std::mutex> lk(_reqMtx);
+    _idleCv.wait(lk, [this]{ return _running == 0; });
+}
+
+void ChunkManager::generateChunk(Chunk& out, int cx, int cy, const World& w) {
+    if (w.mode == Mode::Empty) {
+        out.makeUniform(0); // no generation, no storage: the shared flat block
+        return;
+    }
+    // Chunk layers are row-major (Chunk::Layout), as generateTerrain writes them
+    generateTerrain(out.writableHeights(), cx, cy, 1, w);
+    // Open ocean or fully clamped terrain: give the block back and share the flat one
+    out.shareIfUniform();
+}
+
+const int16_t* ChunkManager::previewHeights(int cx, int cy) const {
+    auto it = _previews.find(ChunkKey{cx, cy});
+    return it == _previews.end() ? nullptr : it->second.data();
+}
+
+namespace {
+    // Amplitude total of an fbm with the given octave count (noise::fbm's normalization)
+    float fbmNorm(int octaves, float gain) {
+        float amp = 0.5f, norm = 0.f;
+        for (int o = 0; o < octaves; ++o) { norm += amp; amp *= gain; }
+        return norm;
+    }
+    // Octaves of an fbm at base frequency freq (cycles per tile) whose lattice cell still spans
+    // two samples step tiles apart; finer ones only alias. Every octave at full resolution.
+    int octavesFor(float freq, int octaves, int step) {
+        if (step <= 1) return octaves;
+        int n = 1;
+        while (n < octaves && freq * (float)(1 << n) * 2.f * (float)step <= 1.f) ++n;
+        return n;
+    }
+}
+
+float ChunkManager::baseFreq(const World& w) {
+    // Keep similar scale to the previous 300x300 map generation: features per ~300 tiles
+    const float f = cfg::NOISE_BASE_SCALE / (float)cfg::GRID;
+    return w.continents ? f * 0.5f : f; // continents: bigger features (twice larger)
+}
+
+float ChunkManager::seaOffset(const World& w) {
+    // Continents: slightly lower sea level for more oceans
+    return cfg::SEA_OFFSET + (w.continents ? 0.8f : 0.f);
+}
+
+void ChunkManager::baseOctaves(float* acc, int cx, int cy, int step, int first, int last, const World& w) {
+    const int S = cfg::CHUNK_SIZE;
+    const int n = S / step + 1;
+    const float worldFreq = baseFreq(w);
+    constexpr int N = cfg::CHUNK_SIZE + 1;
+    float rx[N], ry[N];
+    for (int t = 0; t < n; ++t) {
+        rx[t] = (cx * S + t * step) * worldFreq; // world tile coords, scaled
+        ry[t] = (cy * S + t * step) * worldFreq;
+    }
+    noise::fbmGridOctaves(rx, n, ry, n, acc, w.seed, first, last, 2.0f, 0.5f);
+}
+
+void ChunkManager::generateTerrain(int16_t* out, int cx, int cy, int step, const World& w) {
+    const int n = cfg::CHUNK_SIZE / step + 1; // samples per side
+    if (w.mode == Mode::Empty) {
+        std::fill(out, out + (size_t)n * n, (int16_t)0);
+        return;
+    }
+    // Coarse levels skip the octaves finer than their sample spacing. The sums are rescaled to
+    // the full octave count's normalization, so the dropped detail averages out instead of
+    // stretching the rest.
+    const int baseOct = octavesFor(baseFreq(w), cfg::CHUNK_BASE_OCTAVES, step);
+    thread_local std::vector<float> base;
+    base.assign((size_t)n * n, 0.f);
+    baseOctaves(base.data(), cx, cy, step, 0, baseOct, w);
+    noise::fbmFinish(base.data(), n * n, baseOct, 0.5f); // [-1,1]
+    if (step > 1) {
+        const float baseK = fbmNorm(baseOct, 0.5f) / fbmNorm(cfg::CHUNK_BASE_OCTAVES, 0.5f);
+        for (float& v : base) v *= baseK;
+    }
+    composeTerrain(out, base.data(), cx, cy, step, w);
+}
+
+void ChunkManager::composeTerrain(int16_t* out, const float* base, int cx, int cy, int step, const World& w) {
     const int S = cfg::CHUNK_SIZE;
     // World index of the chunk origin (top-left corner) in tile space
     const int I0 = cx * S;
     const int J0 = cy * S;
+    const int n = S / step + 1; // samples per side
+    const float worldFreq = baseFreq(w);
+    const float seaOff = seaOffset(w);
 
-    if (_mode == Mode::Empty) {
-        std::fill(out.heights.begin(), out.heights.end(), 0);
-        return;
-    }
+    // Effective mountain mask tuning depending on continents toggle
+    const float mFreq     = cfg::MNT_MASK_FREQ * (w.continents ? 0.5f : 1.f);   // larger chains on continents
+    const float mWarp     = cfg::MNT_MASK_WARP * (w.continents ? 0.5f : 1.f);   // less wiggly
+    const float mThresh   = cfg::MNT_MASK_THRESH + (w.continents ? 0.10f : 0.f); // activate less often
+    const float mStrength = cfg::MNT_MASK_STRENGTH * (w.continents ? 0.35f : 1.f); // softer relief
+
+    // Coarse levels drop the mask's sub-stride octaves too (see generateTerrain)
+    const int warpOct = octavesFor(worldFreq * mFreq * 0.5f, 3, step);
+    const int maskOct = octavesFor(worldFreq * mFreq, 4, step);
+    const float warpK = fbmNorm(warpOct, 0.5f) / fbmNorm(3, 0.5f);
+    const float maskK = fbmNorm(maskOct, 0.5f) / fbmNorm(4, 0.5f);
 
-    // Procedural: seamless value-noise FBM in world coordinates
-    // Keep similar scale to the previous 300x300 map generation
-    const float baseScale = cfg::NOISE_BASE_SCALE;
-    // Continents: use larger features and slightly lower sea level for more oceans
-    float worldFreq = baseScale / (float)cfg::GRID; // features per ~300 tiles
-    float seaOffset = cfg::SEA_OFFSET;
-    if (_continents) {
-        worldFreq *= 0.5f;   // bigger features (twice larger)
-        seaOffset  += 0.8f;  // push sea level up => more water
+    // The mask's warp lookups sample separable grids (one x per row, one y per column): fbmGrid
+    // hashes each octave's lattice patch once. The warped mask lookup is irregular and runs
+    // through the batched (SIMD) fbm. Both match fbm() bit for bit.
+    constexpr int N = cfg::CHUNK_SIZE + 1;
+    float rx[N], ry[N], ax[N], ay[N], bx[N], by[N], mx[N], my[N], nm[N];
+    for (int t = 0; t < n; ++t) {
+        rx[t] = (I0 + t * step) * worldFreq; // world tile coords, scaled
+        ry[t] = (J0 + t * step) * worldFreq;
+        const float mcx = rx[t] * mFreq, mcy = ry[t] * mFreq;
+        ax[t] = mcx * 0.5f;           ay[t] = mcy * 0.5f;
+        bx[t] = (mcx + 5.3f) * 0.5f;  by[t] = (mcy - 2.7f) * 0.5f;
     }
+    thread_local std::vector<float> nwx, nwy;
+    nwx.resize((size_t)n * n); nwy.resize((size_t)n * n);
+    noise::fbmGrid(ax, n, ay, n, nwx.data(), w.seed + 9001u, warpOct, 2.0f, 0.5f);  // [-1,1]
+    noise::fbmGrid(bx, n, by, n, nwy.data(), w.seed + 1723u, warpOct, 2.0f, 0.5f);
+    if (step > 1) {
+        for (size_t t = 0; t < (size_t)n * n; ++t) { nwx[t] *= warpK; nwy[t] *= warpK; }
+    }
+    for (int i = 0; i < n; ++i) {
+        const int I = I0 + i * step;
+        const float mcx = rx[i] * mFreq;
+        for (int j = 0; j < n; ++j) {
+            const float wx = nwx[(size_t)i * n + j] * mWarp;
+            const float wy = nwy[(size_t)i * n + j] * mWarp;
+            mx[j] = mcx + wx;
+            my[j] = ry[j] * mFreq + wy;
+        }
+        noise::fbmRow(mx, my, n, nm, w.seed + 1337u, maskOct, 2.0f, 0.5f); // [-1,1]
+        if (step > 1) for (int j = 0; j < n; ++j) nm[j] *= maskK;
 
-    // Effective mountain mask tuning depending on continents toggle
-    const float mFreq     = cfg::MNT_MASK_FREQ * (_continents ? 0.5f : 1.f);   // larger chains on continents
-    const float mWarp     = cfg::MNT_MASK_WARP * (_continents ? 0.5f : 1.f);   // less wiggly
-    const float mThresh   = cfg::MNT_MASK_THRESH + (_continents ? 0.10f : 0.f); // activate less often
-    const float mStrength = cfg::MNT_MASK_STRENGTH * (_continents ? 0.35f : 1.f); // softer relief
-
-    for (int i = 0; i <= S; ++i) {
-        for (int j = 0; j <= S; ++j) {
-            int I = I0 + i; // world tile coords
-            int J = J0 + j;
-            float x = I * worldFreq;
-            float y = J * worldFreq;
-            float n = noise::fbm(x, y, _seed, 5, 2.0f, 0.5f); // [-1,1]
-            float t = 0.5f * (n + 1.0f);                      // [0,1]
+        for (int j = 0; j < n; ++j) {
+            const int J = J0 + j * step;
+            float t = 0.5f * (base[(size_t)i * n + j] + 1.0f); // [0,1]
             float h0 = (float)cfg::MIN_ELEV + t * (float)(cfg::MAX_ELEV - cfg::MIN_ELEV);
-            float h = h0 * cfg::HEIGHT_SCALE - seaOffset;
+            float h = h0 * cfg::HEIGHT_SCALE - seaOff;
             int hi = (int)std::round(h);
 
             // Mountain chain mask: low-frequency ridged band with domain warp
             {
-                float cx = x * mFreq;
-                float cy = y * mFreq;
-                // Domain warp via low-octave fbm noise
-                float nwx = noise::fbm(cx * 0.5f, cy * 0.5f, _seed + 9001u, 3, 2.0f, 0.5f); // [-1,1]
-                float nwy = noise::fbm((cx + 5.3f) * 0.5f, (cy - 2.7f) * 0.5f, _seed + 1723u, 3, 2.0f, 0.5f);
-                float wx = nwx * mWarp;
-                float wy = nwy * mWarp;
-                float nm = noise::fbm(cx + wx, cy + wy, _seed + 1337u, 4, 2.0f, 0.5f); // [-1,1]
-                float nm01 = 0.5f * (nm + 1.f); // [0,1]
+                float nm01 = 0.5f * (nm[j] + 1.f); // [0,1]
                 float mr = 1.f - std::fabs(2.f * nm01 - 1.f); // ridged band [0,1]
                 mr = std::clamp(mr, 0.0f, 1.0f);
                 if (mr > mThresh) {
@@ -141,185 +644,311 @@ void ChunkManager::generateChunk(Chunk& out, int cx, int cy) {
                     h ^= h >> 16; h *= 0x7FEB352Du; h ^= h >> 15; h *= 0x846CA68Bu; h ^= h >> 16;
                     return h;
                 };
-                uint32_t hv = hash2(I, J, _seed ^ 0xBEEF1234u);
+                uint32_t hv = hash2(I, J, w.seed ^ 0xBEEF1234u);
                 float r = (hv & 0xFFFFFF) / 16777215.f; // [0,1]
                 if (r < cfg::RARE_PEAK_PROB) {
                     hi += (int)std::round(cfg::RARE_PEAK_BOOST);
                 }
             }
-            out.heights[Chunk::idx(i, j)] = clampi(hi, cfg::MIN_ELEV, cfg::MAX_ELEV);
+            out[(size_t)i * n + j] = (int16_t)clampi(hi, cfg::MIN_ELEV, cfg::MAX_ELEV);
+        }
+    }
+}
+
+static_assert(cfg::CHUNK_PREVIEW_OCTAVES <= cfg::CHUNK_BASE_OCTAVES, "the preview runs a prefix of the base octaves");
+
+void ChunkManager::previewChunk(Staged& s, int16_t* out, int cx, int cy, const World& w) {
+    const int P = cfg::CHUNK_PREVIEW_OCTAVES;
+    s.base.assign(ChunkPool::VERTS, 0.f);
+    baseOctaves(s.base.data(), cx, cy, 1, 0, P, w);
+    // The base alone, rescaled like a coarse level's (generateTerrain) so the missing octaves
+    // average out; the mask and peaks come with the second pass
+    const float k = fbmNorm(P, 0.5f) / fbmNorm(cfg::CHUNK_BASE_OCTAVES, 0.5f);
+    const float seaOff = seaOffset(w);
+    thread_local std::vector<float> base;
+    base = s.base;
+    noise::fbmFinish(base.data(), ChunkPool::VERTS, P, 0.5f);
+    for (int t = 0; t < ChunkPool::VERTS; ++t) {
+        const float t01 = 0.5f * (base[(size_t)t] * k + 1.0f);
+        const float h0 = (float)cfg::MIN_ELEV + t01 * (float)(cfg::MAX_ELEV - cfg::MIN_ELEV);
+        out[t] = (int16_t)clampi((int)std::round(h0 * cfg::HEIGHT_SCALE - seaOff), cfg::MIN_ELEV, cfg::MAX_ELEV);
+    }
+    s.ch.overrides().forEach([out](int v, int value){ out[v] = (int16_t)value; });
+}
+
+void ChunkManager::refineChunk(Staged& s, Chunk& out, int cx, int cy, const World& w) {
+    // Same sums, same order as a single pass: the heights match generateChunk's bit for bit
+    baseOctaves(s.base.data(), cx, cy, 1, cfg::CHUNK_PREVIEW_OCTAVES, cfg::CHUNK_BASE_OCTAVES, w);
+    noise::fbmFinish(s.base.data(), ChunkPool::VERTS, cfg::CHUNK_BASE_OCTAVES, 0.5f);
+    composeTerrain(out.writableHeights(), s.base.data(), cx, cy, 1, w);
+    out.shareIfUniform();
+}
+
+// ===== Coarse resolution levels =====
+void ChunkManager::sampleLevel(const int16_t* full, int level, int16_t* out) {
+    const int step = levelStride(level), n = levelSide(level);
+    for (int i = 0; i < n; ++i)
+        for (int j = 0; j < n; ++j) out[(size_t)i * n + j] = full[Chunk::idx(i * step, j * step)];
+}
+
+const int16_t* ChunkManager::levelHeights(int cx, int cy, int level) {
+    if (level <= 0 || level >= cfg::CHUNK_LOD_LEVELS) return nullptr;
+    LevelEntry* e = _levelCache.get(LevelChunkKey{wk(ChunkKey{cx, cy}), level});
+    if (!e) return nullptr;
+    e->lastFrame = _frame;
+    if (!e->exact) {
+        // Upgrade in place: the full chunk arrived since (zooming in, or generated nearby)
+        const Entry* full = _cache.find(wk(ChunkKey{cx, cy}));
+        if (full && full->ch.materialized()) {
+            sampleLevel(full->ch.heightData(), level, e->heights.data());
+            e->exact = true;
         }
     }
+    return e->heights.data();
+}
+
+int ChunkManager::buildLevel(const std::vector<ChunkKey>& keys, int level, int maxNew) {
+    if (level <= 0 || level >= cfg::CHUNK_LOD_LEVELS) return 0;
+    const int step = levelStride(level), n = levelSide(level);
+    const size_t bytes = levelBytes(level);
+    const uint32_t frame = _frame;
+    auto evictable = [frame](const LevelEntry& e){ return e.lastFrame + 1 < frame; };
+    std::vector<std::pair<ChunkKey, LevelEntry*>> todo;
+    int built = 0;
+    for (const ChunkKey& k : keys) {
+        if ((int)todo.size() >= maxNew) break;
+        const LevelChunkKey lk{wk(k), level};
+        if (_levelCache.find(lk)) continue;
+        // Over budget is fine when the levels drawn now need it
+        while (_levelBytes + bytes > cfg::CHUNK_LOD_CACHE_BYTES) {
+            const LevelChunkKey* v = _levelCache.victim(evictable);
+            if (!v) break;
+            const LevelChunkKey victim = *v;
+            _levelCache.erase(victim);
+            _levelBytes -= levelBytes(victim.level);
+        }
+        if (_levelCache.full()) _levelCache.grow(_levelCache.capacity() * 2);
+        LevelEntry fresh;
+        fresh.heights.resize((size_t)n * n);
+        fresh.lastFrame = frame;
+        LevelEntry& e = _levelCache.insert(lk, std::move(fresh));
+        _levelBytes += bytes;
+        ++built;
+        const Entry* full = _cache.find(wk(k));
+        if (full && full->ch.materialized()) {
+            sampleLevel(full->ch.heightData(), level, e.heights.data()); // no noise to run
+            e.exact = true;
+        } else {
+            todo.emplace_back(k, &e);
+        }
+    }
+    const World w = _world;
+    _pool.parallelFor((int)todo.size(), [&](int t){
+        const ChunkKey k = todo[(size_t)t].first;
+        int16_t* h = todo[(size_t)t].second->heights.data();
+        generateTerrain(h, k.cx, k.cy, step, w);
+        // Edits on the sampled vertices show at every level
+        Chunk edits(_chunkPool);
+        loadOverrides(edits, k.cx, k.cy, w);
+        edits.overrides().forEach([&](int v, int value){
+            const int i = v / (cfg::CHUNK_SIZE + 1), j = v % (cfg::CHUNK_SIZE + 1);
+            if (i % step == 0 && j % step == 0) h[(size_t)(i / step) * n + j / step] = (int16_t)value;
+        });
+    });
+    return built;
+}
+
+void ChunkManager::eraseLevels(const WorldChunkKey& key) {
+    for (int l = 1; l < cfg::CHUNK_LOD_LEVELS; ++l) {
+        const LevelChunkKey lk{key, l};
+        if (!_levelCache.find(lk)) continue;
+        _levelCache.erase(lk);
+        _levelBytes -= levelBytes(l);
+    }
+}
+
+void ChunkManager::eraseLevelWorlds(const std::string& dir, uint32_t except) {
+    std::vector<LevelChunkKey> keys;
+    _levelCache.forEach([&](const LevelChunkKey& k, LevelEntry&){
+        if (k.key.world != except && _worlds[k.key.world].dir == dir) keys.push_back(k);
+    });
+    for (const LevelChunkKey& k : keys) {
+        _levelCache.erase(k);
+        _levelBytes -= levelBytes(k.level);
+    }
 }
 
-void ChunkManager::applySetAt(int I, int J, int value) {
+void ChunkManager::editRegion(int I0, int J0, int I1, int J1, EditOp op, int value, const uint8_t* mask) {
+    switch (op) {
+    case EditOp::Add:
+        editRegionWith(I0, J0, I1, J1, [value](int, int, int h, bool){ return h + value; }, mask);
+        break;
+    case EditOp::AddToEdits:
+        // The water view already reads 0 where unedited: no terrain needed
+        editRegionWith(I0, J0, I1, J1, [value](int, int, int h, bool){ return h + value; }, mask, Layer::Overrides);
+        break;
+    case EditOp::Set:
+        editRegionWith(I0, J0, I1, J1, [value](int, int, int, bool){ return value; }, mask, Layer::Overrides);
+        break;
+    }
+}
+
+void ChunkManager::editRegionImpl(int I0, int J0, int I1, int J1, EditFn fn, void* ctx, const uint8_t* mask, bool heights) {
+    if (I1 < I0 || J1 < J0) return;
+    _worldEdited = true;
     const int S = cfg::CHUNK_SIZE;
-    int cx = floorDiv(I, S);
-    int cy = floorDiv(J, S);
-    int li = clampi(I - cx * S, 0, S);
-    int lj = clampi(J - cy * S, 0, S);
-
-    auto ensureChunk = [&](int ecx, int ecy) -> Entry& {
-        ChunkKey k{ecx, ecy};
-        auto it = _cache.find(k);
-        if (it == _cache.end()) {
-            Entry e{};
-            generateChunk(e.ch, ecx, ecy);
-            _lru.push_front(k);
-            e.it = _lru.begin();
-            it = _cache.emplace(k, std::move(e)).first;
-            while (_cache.size() > static_cast<size_t>(cfg::MAX_CACHED_CHUNKS)) {
-                const ChunkKey& oldKey = _lru.back();
-                _cache.erase(oldKey);
-                _lru.pop_back();
+    const int W = J1 - J0 + 1;
+    _editValues.resize((size_t)(I1 - I0 + 1) * W);
+
+    // The stroke's chunks stay pinned until both passes are done
+    std::vector<Pin> pins;
+
+    // Pass 1: each vertex is evaluated once, in the chunk that owns it (local index < S)
+    for (int cx = floorDiv(I0, S); cx <= floorDiv(I1, S); ++cx) {
+        for (int cy = floorDiv(J0, S); cy <= floorDiv(J1, S); ++cy) {
+            const ChunkKey key{cx, cy};
+            Entry& e = acquire(key, heights);
+            pins.push_back(makePin(key, e));
+            Chunk& ch = e.ch;
+            const int16_t* src = heights ? ch.heightData() : ch.waterData();
+            const int ia = std::max(I0, cx * S), ib = std::min(I1, cx * S + S - 1);
+            const int ja = std::max(J0, cy * S), jb = std::min(J1, cy * S + S - 1);
+            const int n = jb - ja + 1;
+            for (int I = ia; I <= ib; ++I) {
+                const int row = (I - I0) * W - J0;
+                const int base = Chunk::idx(I - cx * S, 0) - cy * S;
+                // Edited flags of the row: overrides read over a sentinel (one search per row)
+                _editRow.assign((size_t)n, INT_MIN);
+                ch.overrides().read(base + ja, n, _editRow.data());
+                for (int J = ja; J <= jb; ++J) {
+                    if (mask && !mask[row + J]) continue;
+                    const int k = base + J;
+                    const bool edited = _editRow[J - ja] != INT_MIN;
+                    int v = clampi(fn(ctx, I, J, src[k], edited), cfg::MIN_ELEV, cfg::MAX_ELEV);
+                    _editValues[row + J] = v;
+                    _journal.record(I, J, v);
+                }
             }
-        } else {
-            _lru.erase(it->second.it);
-            _lru.push_front(k);
-            it->second.it = _lru.begin();
         }
-        return it->second;
-    };
-
-    int v = clampi(value, cfg::MIN_ELEV, cfg::MAX_ELEV);
-
-    auto writeTo = [&](int ecx, int ecy, int lli, int llj){
-        Entry& e = ensureChunk(ecx, ecy);
-        int kk = Chunk::idx(lli, llj);
-        e.ch.overrides[kk] = v;
-        e.ch.overrideMask[kk] = 1u;
-        e.ch.heights[kk] = v;
-        e.dirty = true;
-    };
-
-    // Primary chunk
-    writeTo(cx, cy, li, lj);
-    // Mirror across edges/corners
-    if (li == 0)        writeTo(cx - 1, cy, S, lj);
-    if (li == S)        writeTo(cx + 1, cy, 0, lj);
-    if (lj == 0)        writeTo(cx, cy - 1, li, S);
-    if (lj == S)        writeTo(cx, cy + 1, li, 0);
-    if (li == 0 && lj == 0)     writeTo(cx - 1, cy - 1, S, S);
-    if (li == 0 && lj == S)     writeTo(cx - 1, cy + 1, S, 0);
-    if (li == S && lj == 0)     writeTo(cx + 1, cy - 1, 0, S);
-    if (li == S && lj == S)     writeTo(cx + 1, cy + 1, 0, 0);
-}
-
-void ChunkManager::applyDeltaAt(int I, int J, int delta) {
+    }
+    // Pass 2: write into every chunk holding each vertex (owners plus the neighbours that
+    // share their edge row/column)
+    for (int cx = floorDiv(I0 - 1, S); cx <= floorDiv(I1, S); ++cx) {
+        for (int cy = floorDiv(J0 - 1, S); cy <= floorDiv(J1, S); ++cy) {
+            const int ia = std::max(I0, cx * S), ib = std::min(I1, cx * S + S);
+            const int ja = std::max(J0, cy * S), jb = std::min(J1, cy * S + S);
+            if (ia > ib || ja > jb) continue;
+            const ChunkKey key{cx, cy};
+            Entry& e = acquire(key, heights);
+            pins.push_back(makePin(key, e));
+            Chunk& ch = e.ch;
+            for (int I = ia; I <= ib; ++I) {
+                const int row = (I - I0) * W - J0;
+                const int k0 = Chunk::idx(I - cx * S, ja - cy * S);
+                ch.setOverrides(k0, jb - ja + 1, &_editValues[(size_t)(row + ja)], mask ? mask + (row + ja) : nullptr);
+            }
+            // The override layer grows with the edits: keep the budget accounting exact
+            reaccount(e);
+            eraseLevels(wk(key)); // resampled from this chunk when next drawn coarse
+        }
+    }
+    // Pass 3: shadow halos holding edited vertices (only the ones already filled)
+    if (cfg::SHADOW_HALO <= 0) return;
+    for (int cx = floorDiv(I0 - 1, S); cx <= floorDiv(I1, S); ++cx) {
+        for (int cy = floorDiv(J0, S) + 1; cy <= floorDiv(J1 + cfg::SHADOW_HALO, S); ++cy) {
+            Entry* e = _cache.find(wk(ChunkKey{cx, cy}));
+            if (!e || !e->ch.halo()) continue;
+            const int ia = std::max(I0, cx * S), ib = std::min(I1, cx * S + S);
+            const int ja = std::max(J0, cy * S - cfg::SHADOW_HALO), jb = std::min(J1, cy * S - 1);
+            int16_t* h = e->ch.writableHalo();
+            for (int I = ia; I <= ib; ++I) {
+                const int row = (I - I0) * W - J0;
+                for (int J = ja; J <= jb; ++J) {
+                    if (mask && !mask[row + J]) continue;
+                    h[Chunk::haloIdx(I - cx * S, J - cy * S)] = (int16_t)_editValues[row + J];
+                }
+            }
+        }
+    }
+}
+
+void ChunkManager::readRegion(int I0, int J0, int I1, int J1, Layer layer, int* out, size_t stride, int cacheNew) {
+    if (I1 < I0 || J1 < J0) return;
     const int S = cfg::CHUNK_SIZE;
-    int cx = floorDiv(I, S);
-    int cy = floorDiv(J, S);
-    int li = clampi(I - cx * S, 0, S);
-    int lj = clampi(J - cy * S, 0, S);
-
-    auto ensureChunk = [&](int ecx, int ecy) -> Entry& {
-        ChunkKey k{ecx, ecy};
-        auto it = _cache.find(k);
-        if (it == _cache.end()) {
-            Entry e{};
-            generateChunk(e.ch, ecx, ecy);
-            _lru.push_front(k);
-            e.it = _lru.begin();
-            it = _cache.emplace(k, std::move(e)).first;
-            while (_cache.size() > static_cast<size_t>(cfg::MAX_CACHED_CHUNKS)) {
-                const ChunkKey& oldKey = _lru.back();
-                _cache.erase(oldKey);
-                _lru.pop_back();
+    if (stride == 0) stride = (size_t)(J1 - J0 + 1);
+    Chunk scratch(_chunkPool);
+    // Each vertex is read from the chunk that owns it (local index < S)
+    for (int cx = floorDiv(I0, S); cx <= floorDiv(I1, S); ++cx) {
+        for (int cy = floorDiv(J0, S); cy <= floorDiv(J1, S); ++cy) {
+            const ChunkKey key{cx, cy};
+            const int ia = std::max(I0, cx * S), ib = std::min(I1, cx * S + S - 1);
+            const int ja = std::max(J0, cy * S), jb = std::min(J1, cy * S + S - 1);
+            const Chunk* src = nullptr;
+            Entry* e = _cache.find(wk(key));
+            if (e) {
+                src = &e->ch;
+            } else if (layer != Layer::Generated) {
+                scratch = Chunk(_chunkPool);
+                if (_tier.peek(wk(key), scratch)) {
+                    src = &scratch;
+                } else if (cacheNew > 0) {
+                    --cacheNew;
+                    src = &getChunk(cx, cy, layer);
+                } else {
+                    if (layer == Layer::Composited) generateChunk(scratch, cx, cy, _world);
+                    loadOverrides(scratch, cx, cy, _world);
+                    src = &scratch;
+                }
+            }
+            if (layer == Layer::Composited && !src->materialized()) {
+                // Loaded with edits only (water-only view): generate the terrain now
+                if (e) {
+                    materialize(key, *e);
+                } else {
+                    Chunk g(_chunkPool);
+                    generateChunk(g, cx, cy, _world);
+                    scratch.adoptHeights(std::move(g));
+                }
+            }
+            if (layer == Layer::Generated) {
+                // Edited vertices no longer hold the generated height: rebuild when any is in range
+                bool edited = false;
+                for (int I = ia; I <= ib && src && !edited; ++I)
+                    edited = src->overrides().any(Chunk::idx(I - cx * S, ja - cy * S), jb - ja + 1);
+                if (!src || edited || !src->materialized()) {
+                    scratch = Chunk(_chunkPool);
+                    generateChunk(scratch, cx, cy, _world);
+                    src = &scratch;
+                }
+            }
+            for (int I = ia; I <= ib; ++I) {
+                int* row = out + (size_t)(I - I0) * stride + (ja - J0);
+                const int k0 = Chunk::idx(I - cx * S, ja - cy * S);
+                const int n = jb - ja + 1;
+                if (layer == Layer::Overrides) src->readOverrides(k0, n, row);
+                else src->readHeights(k0, n, row);
             }
-        } else {
-            _lru.erase(it->second.it);
-            _lru.push_front(k);
-            it->second.it = _lru.begin();
         }
-        return it->second;
-    };
-
-    // Determine target value from primary chunk height + delta
-    Entry& e0 = ensureChunk(cx, cy);
-    int k0 = Chunk::idx(li, lj);
-    int base = e0.ch.overrideMask[k0] ? e0.ch.overrides[k0] : e0.ch.heights[k0];
-    int v = clampi(base + delta, cfg::MIN_ELEV, cfg::MAX_ELEV);
-
-    auto writeTo = [&](int ecx, int ecy, int lli, int llj){
-        Entry& e = ensureChunk(ecx, ecy);
-        int kk = Chunk::idx(lli, llj);
-        e.ch.overrides[kk] = v;
-        e.ch.overrideMask[kk] = 1u;
-        e.ch.heights[kk] = v;
-        e.dirty = true;
-    };
-
-    // Write to primary and neighbors
-    writeTo(cx, cy, li, lj);
-    if (li == 0)        writeTo(cx - 1, cy, S, lj);
-    if (li == S)        writeTo(cx + 1, cy, 0, lj);
-    if (lj == 0)        writeTo(cx, cy - 1, li, S);
-    if (lj == S)        writeTo(cx, cy + 1, li, 0);
-    if (li == 0 && lj == 0)     writeTo(cx - 1, cy - 1, S, S);
-    if (li == 0 && lj == S)     writeTo(cx - 1, cy + 1, S, 0);
-    if (li == S && lj == 0)     writeTo(cx + 1, cy - 1, 0, S);
-    if (li == S && lj == S)     writeTo(cx + 1, cy + 1, 0, 0);
+    }
 }
 
 // ===== Persistence helpers =====
-string ChunkManager::chunkPath(int cx, int cy) const {
-    // maps/seed_<seed>[_cont]/cX_Y.csv
+string ChunkManager::worldDir(const World& w) {
+    // maps/seed_<seed>[_cont]
     std::ostringstream oss;
-    oss << "maps/seed_" << _seed;
-    if (_continents) oss << "_cont";
-    string dir = oss.str();
-    std::ostringstream fn;
-    fn << dir << "/c" << cx << "_" << cy << ".csv";
-    return fn.str();
+    oss << "maps/seed_" << w.seed;
+    if (w.continents) oss << "_cont";
+    return oss.str();
 }
 
-void ChunkManager::ensureDir() const {
-    std::ostringstream oss;
-    oss << "maps/seed_" << _seed;
-    if (_continents) oss << "_cont";
-    fs::path p(oss.str());
-    std::error_code ec;
-    fs::create_directories(p, ec);
-}
-
-void ChunkManager::loadOverrides(Chunk& ch, int cx, int cy) {
-    // Reset masks (in case caller reuses chunk object)
-    std::fill(ch.overrideMask.begin(), ch.overrideMask.end(), 0);
-    std::fill(ch.overrides.begin(), ch.overrides.end(), 0);
-    string path = chunkPath(cx, cy);
-    std::ifstream in(path);
-    if (!in) return;
-    const int S1 = cfg::CHUNK_SIZE + 1;
-    string line;
-    while (std::getline(in, line)) {
-        if (line.empty()) continue;
-        std::stringstream ss(line);
-        string a,b,c;
-        if (!std::getline(ss, a, ',')) continue;
-        if (!std::getline(ss, b, ',')) continue;
-        if (!std::getline(ss, c, ',')) continue;
-        int i = 0, j = 0, v = 0;
-        try { i = std::stoi(a); j = std::stoi(b); v = std::stoi(c); } catch (...) { continue; }
-        if (i < 0 || j < 0 || i >= S1 || j >= S1) continue;
-        int k = Chunk::idx(i, j);
-        v = clampi(v, cfg::MIN_ELEV, cfg::MAX_ELEV);
-        ch.overrides[k] = v;
-        ch.overrideMask[k] = 1u;
-        ch.heights[k] = v; // apply on top of generated
-    }
-}
-
-void ChunkManager::saveOverrides(const Chunk& ch, int cx, int cy) {
-    ensureDir();
-    string path = chunkPath(cx, cy);
-    std::ofstream out(path, std::ios::trunc);
-    if (!out) return;
-    const int S1 = cfg::CHUNK_SIZE + 1;
-    for (int i = 0; i < S1; ++i) {
-        for (int j = 0; j < S1; ++j) {
-            int k = Chunk::idx(i, j);
-            if (!ch.overrideMask[k]) continue;
-            out << i << "," << j << "," << ch.overrides[k] << "\n";
-        }
-    }
+void ChunkManager::loadOverrides(Chunk& ch, int cx, int cy, const World& w) {
+    // ch comes from the pool (or a fresh Chunk): override layers are already cleared
+    // Journal edits first: if a compaction lands before the region read, they are merely re-applied
+    std::vector<EditJournal::Edit> edits;
+    _journal.collect(w.dir, cx, cy, edits);
+    // A snapshot still waiting for the writer is newer than the region file
+    WriteBehind::Blob snap;
+    if (_flusher.pending(w.dir, cx, cy, snap)) chunkstore::decode(snap->data(), snap->size(), ch);
+    else _regions.load(w.dir, cx, cy, ch);
+    EditJournal::apply(edits, ch);
 }
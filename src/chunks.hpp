@@ -1,83 +1,508 @@
 #pragma once
 #include <vector>
 #include <unordered_map>
-#include <list>
 #include <cstdint>
+#include <algorithm>
+#include <type_traits>
 #include <utility>
 #include <string>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
 #include "config.hpp"
+#include "chunkkey.hpp"
+#include "gridlayout.hpp"
+#include "threadpool.hpp"
+#include "chunkpool.hpp"
+#include "chunkoverrides.hpp"
+#include "chunkcache.hpp"
+#include "regionfile.hpp"
+#include "writebehind.hpp"
+#include "journal.hpp"
+#include "chunktier.hpp"
+#include <chrono>
 
-// Chunked world primitives
-struct ChunkKey {
-    int cx;
-    int cy;
-    bool operator==(const ChunkKey& o) const noexcept { return cx == o.cx && cy == o.cy; }
-};
+// One (CHUNK_SIZE+1)^2 int16 layer of a chunk: a private block from the chunk's pool, a shared
+// read-only uniform block (ChunkPool::uniform), or nothing yet (not materialized).
+// Writing through mut() copies a shared block into a private one first (copy-on-write).
+class HeightLayer {
+public:
+    const int16_t* data() const { return _data; }
+    bool present() const { return _data != nullptr; }
+    bool shared() const { return _data && !_own; }
+    size_t bytes() const { return _own ? ChunkPool::BLOCK_BYTES : 0; }
 
-struct ChunkKeyHash {
-    size_t operator()(const ChunkKey& k) const noexcept {
-        // 64-bit mix
-        uint64_t x = static_cast<uint64_t>(static_cast<uint32_t>(k.cx));
-        uint64_t y = static_cast<uint64_t>(static_cast<uint32_t>(k.cy));
-        uint64_t h = x * 0x9E3779B185EBCA87ULL ^ (y + 0xC2B2AE3D27D4EB4FULL + (x<<6) + (x>>2));
-        return static_cast<size_t>(h ^ (h >> 32));
+    // Private block (contents unspecified when the layer was absent)
+    int16_t* mut(ChunkPool* pool) {
+        if (_own) return _own;
+        _own = pool ? pool->acquire() : ChunkPool::allocate();
+        if (_data) std::copy(_data, _data + ChunkPool::VERTS, _own);
+        _data = _own;
+        return _own;
+    }
+    void share(int v, ChunkPool* pool) { release(pool); _data = ChunkPool::uniform(v); }
+    // Switches to the shared block when every value is the same; true if shared afterwards
+    bool shareIfUniform(ChunkPool* pool) {
+        if (!_own) return _data != nullptr;
+        const int16_t v = _own[0];
+        for (int k = 1; k < ChunkPool::VERTS; ++k)
+            if (_own[k] != v) return false;
+        share(v, pool);
+        return true;
     }
+    void release(ChunkPool* pool) {
+        if (_own) {
+            if (pool) pool->release(_own);
+            else ChunkPool::deallocate(_own);
+        }
+        _data = _own = nullptr;
+    }
+    // Takes o's block (o is left absent)
+    void take(HeightLayer& o) { _data = o._data; _own = o._own; o._data = o._own = nullptr; }
+
+private:
+    const int16_t* _data = nullptr;
+    int16_t* _own = nullptr;
 };
 
+// Chunk layers, each materialized on demand:
+//   heights    generated terrain with edits composited (absent until generated)
+//   overrides  the user's edits (sparse)
+//   water      edits over sea level 0, what the water-only view draws: the shared flat block
+//              while unedited, a block kept in step with sparse overrides, then the dense
+//              override values themselves
 struct Chunk {
-    // Heights at grid intersections: (CHUNK_SIZE+1) x (CHUNK_SIZE+1)
-    std::vector<int> heights;
-    // Overrides: if mask[k]!=0, heights[k] has been forced to overrides[k]
-    std::vector<int> overrides;
-    std::vector<uint8_t> overrideMask;
-    Chunk()
-        : heights((cfg::CHUNK_SIZE + 1) * (cfg::CHUNK_SIZE + 1), 0)
-        , overrides((cfg::CHUNK_SIZE + 1) * (cfg::CHUNK_SIZE + 1), 0)
-        , overrideMask((cfg::CHUNK_SIZE + 1) * (cfg::CHUNK_SIZE + 1), 0) {}
-    static inline int idx(int i, int j) { return i * (cfg::CHUNK_SIZE + 1) + j; }
+    // Standalone chunk, flat at sea level (shares the uniform block until written)
+    Chunk() { _heights.share(0, nullptr); _water.share(0, nullptr); }
+    // Blocks taken from (and returned to) pool; heights stay absent until generated
+    explicit Chunk(ChunkPool& pool) : _pool(&pool) { _water.share(0, _pool); }
+    ~Chunk() { release(); }
+    Chunk(Chunk&& o) noexcept { take(o); }
+    Chunk& operator=(Chunk&& o) noexcept { if (this != &o) { release(); take(o); } return *this; }
+    Chunk(const Chunk&) = delete;
+    Chunk& operator=(const Chunk&) = delete;
+
+    // Vertices at grid intersections: (CHUNK_SIZE+1) x (CHUNK_SIZE+1), indexed by idx(i, j).
+    // Fixed row-major; the bulk paths assume it (see gridlayout.hpp, bench layout)
+    using Layout = layout::RowMajor<cfg::CHUNK_SIZE + 1>;
+    static inline int idx(int i, int j) { return Layout::index(i, j); }
+
+    // Composited heights (generated, or the override where edited). Only valid once
+    // materialized(); ChunkManager hands out chunks with heights unless asked for edits only.
+    bool materialized() const { return _heights.present(); }
+    int height(int k) const { return _heights.data()[k]; }
+    // Generator side: v must already be clamped to cfg::MIN_ELEV..cfg::MAX_ELEV
+    void setHeight(int k, int v) { _heights.mut(_pool)[k] = (int16_t)v; }
+    const int16_t* heightData() const { return _heights.data(); }
+    // Private, writable heights (copies a shared block; contents unspecified when absent)
+    int16_t* writableHeights() { return _heights.mut(_pool); }
+    // out[t] = height of vertex k0+t
+    void readHeights(int k0, int n, int* out) const { widen(_heights.data() + k0, n, out); }
+
+    // Uniform heights share one read-only block and hold no storage of their own
+    bool shared() const { return _heights.shared(); }
+    // Heights flat at v (edits are not re-applied: for chunks without overrides)
+    void makeUniform(int v) { _heights.share(v, _pool); }
+    bool shareIfUniform() { return _heights.shareIfUniform(_pool); }
+    // Takes the heights of g (freshly generated from the same world, same pool) and
+    // composites this chunk's overrides over them
+    void adoptHeights(Chunk&& g);
+
+    // User edits: an edited vertex is forced to its override value
+    bool edited(int k) const { return _overrides.contains(k); }
+    int overrideAt(int k) const { return waterData()[k]; } // 0 (sea level) when not edited
+    void setOverride(int k, int v) {
+        _overrides.set(k, v);
+        if (_overrides.dense()) _water.release(_pool);
+        else _water.mut(_pool)[k] = (int16_t)v;
+        if (_heights.present()) _heights.mut(_pool)[k] = (int16_t)v;
+    }
+    // setOverride(k0+t, vals[t]) for t in [0, n) where mask is null or mask[t] != 0
+    void setOverrides(int k0, int n, const int* vals, const uint8_t* mask);
+    const ChunkOverrides& overrides() const { return _overrides; }
+    // Water view: override where edited, 0 elsewhere
+    const int16_t* waterData() const {
+        const int16_t* d = _overrides.dense();
+        return d ? d : _water.data();
+    }
+    // out[t] = override of vertex k0+t, 0 when not edited
+    void readOverrides(int k0, int n, int* out) const { widen(waterData() + k0, n, out); }
+
+    // Shadow halo: the cfg::SHADOW_HALO composited heights before each row along J (the side
+    // the light comes from), neighbour vertex (i, j) for j in [-SHADOW_HALO, -1] at haloIdx(i, j).
+    // Absent until ChunkManager::halo fills it.
+    static constexpr int haloIdx(int i, int j) { return layout::Halo<cfg::SHADOW_HALO>::index(i, j); }
+    const int16_t* halo() const { return _halo.empty() ? nullptr : _halo.data(); }
+    int16_t* writableHalo() {
+        _halo.resize((size_t)(cfg::CHUNK_SIZE + 1) * cfg::SHADOW_HALO);
+        return _halo.data();
+    }
+
+    // Heap memory held by this chunk's layers (a shared block belongs to no chunk)
+    size_t bytes() const {
+        return _heights.bytes() + _water.bytes() + _overrides.bytes() + _halo.capacity() * sizeof(int16_t);
+    }
+
+private:
+    HeightLayer _heights;
+    HeightLayer _water;
+    ChunkPool* _pool = nullptr;
+    ChunkOverrides _overrides;
+    std::vector<int16_t> _halo;
+
+    static void widen(const int16_t* h, int n, int* out) {
+        int t = 0;
+        // Fixed-width blocks: widened with vector instructions even at -O2
+        for (; t + 8 <= n; t += 8)
+            for (int u = 0; u < 8; ++u) out[t + u] = h[t + u];
+        for (; t < n; ++t) out[t] = h[t];
+    }
+    void release() {
+        _heights.release(_pool);
+        _water.release(_pool);
+        _overrides.clear();
+        std::vector<int16_t>().swap(_halo);
+    }
+    void take(Chunk& o) {
+        _heights.take(o._heights); _water.take(o._water); _pool = o._pool;
+        _overrides = std::move(o._overrides);
+        o._overrides.clear();
+        _halo.swap(o._halo);
+    }
 };
 
+constexpr bool lodStridesDivideChunk() {
+    for (int l = 0; l < cfg::CHUNK_LOD_LEVELS; ++l)
+        if (cfg::CHUNK_LOD_STRIDES[l] <= 0 || cfg::CHUNK_SIZE % cfg::CHUNK_LOD_STRIDES[l] != 0) return false;
+    return cfg::CHUNK_LOD_STRIDES[0] == 1;
+}
+static_assert(lodStridesDivideChunk(), "level strides must divide CHUNK_SIZE, level 0 being the full chunk");
+
 class ChunkManager {
 public:
     enum class Mode { Empty, Procedural };
 
-    explicit ChunkManager() : _mode(Mode::Empty), _seed(0) {}
-
-    void setMode(Mode m, uint32_t seed) {
-        _mode = m; _seed = seed; _cache.clear();
+    // workers: background generation threads (0 = hardware threads - 1)
+    explicit ChunkManager(unsigned workers = cfg::CHUNK_WORKER_THREADS)
+        : _flusher(_regions, cfg::FLUSH_QUEUE_MAX), _journal(_regions, _flusher), _pool(workers) {
+        _worlds.push_back(_world);
+        _journal.open(_world.dir);
     }
-    Mode mode() const { return _mode; }
-    uint32_t seed() const { return _seed; }
-    void setContinents(bool c) { _continents = c; clear(); }
-    bool continents() const { return _continents; }
+    // Commits pending edits and waits for queued region writes
+    ~ChunkManager();
 
-    // Get or build chunk at (cx, cy)
-    const Chunk& getChunk(int cx, int cy);
+    // World selection. Chunks of the worlds left behind stay cached under the shared budget
+    // and are evicted by global recency, so switching back to a recent world is immediate.
+    void setMode(Mode m, uint32_t seed) { World w = _world; w.mode = m; w.seed = seed; selectWorld(w); }
+    Mode mode() const { return _world.mode; }
+    uint32_t seed() const { return _world.seed; }
+    void setContinents(bool c) { World w = _world; w.continents = c; selectWorld(w); }
+    bool continents() const { return _world.continents; }
+
+    // Chunk layers, as read by readRegion and requested by the acquisition calls below
+    enum class Layer {
+        Generated,  // procedural terrain, ignoring user edits
+        Overrides,  // user edits only, sea level (0) elsewhere (water-only view)
+        Composited, // terrain with edits applied (what is drawn)
+    };
+
+    // Generation worker pool, shared with other batch work (terrain::generateMap)
+    ThreadPool& workers() { return _pool; }
+
+    // Get or build chunk at (cx, cy) synchronously (blocks on generation). need =
+    // Layer::Overrides skips terrain generation: only the edits and the water view of the
+    // returned chunk are valid (heights are generated later, when a caller needs them).
+    const Chunk& getChunk(int cx, int cy, Layer need = Layer::Composited);
+
+    // Non-blocking acquisition: returns the chunk if resident, otherwise queues it
+    // for generation on the worker pool and returns nullptr (pending). With need =
+    // Layer::Overrides nothing is generated: the edits are loaded right away.
+    const Chunk* tryGetChunk(int cx, int cy, Layer need = Layer::Composited);
+
+    // Builds the listed chunks (Layer::Composited) that are not resident yet, fanned out over
+    // the worker pool and the calling thread; returns once all of them are cached. Chunks are
+    // generated independently, so the result is the same as getChunk on each. A batch larger
+    // than the cache budget evicts its own first chunks. Returns the number generated.
+    int generateChunks(const std::vector<ChunkKey>& keys);
+
+    // RAII handle on a resident chunk: while any pin is alive the chunk is never evicted,
+    // whatever the budget. Pins taken before clear() or resetOverrides() no longer point at
+    // a chunk (the cache was dropped) and release as no-ops.
+    class Pin {
+    public:
+        Pin() = default;
+        Pin(Pin&& o) noexcept : _mgr(o._mgr), _key(o._key), _ch(o._ch), _serial(o._serial) { o._mgr = nullptr; o._ch = nullptr; }
+        Pin& operator=(Pin&& o) noexcept {
+            if (this != &o) {
+                reset();
+                _mgr = o._mgr; _key = o._key; _ch = o._ch; _serial = o._serial;
+                o._mgr = nullptr; o._ch = nullptr;
+            }
+            return *this;
+        }
+        Pin(const Pin&) = delete;
+        Pin& operator=(const Pin&) = delete;
+        ~Pin() { reset(); }
+
+        explicit operator bool() const { return _ch != nullptr; }
+        const Chunk& operator*() const { return *_ch; }
+        const Chunk* operator->() const { return _ch; }
+        const Chunk* get() const { return _ch; }
+        const ChunkKey& key() const { return _key.chunk; }
+        void reset();
+
+    private:
+        friend class ChunkManager;
+        Pin(ChunkManager* m, const WorldChunkKey& k, const Chunk* c, uint64_t serial) : _mgr(m), _key(k), _ch(c), _serial(serial) {}
+        ChunkManager* _mgr = nullptr;
+        WorldChunkKey _key{};
+        const Chunk* _ch = nullptr;
+        uint64_t _serial = 0; // entry the pin was taken on (a dropped and reloaded chunk is another)
+    };
+    // getChunk + pin (blocks on generation)
+    Pin pin(int cx, int cy, Layer need = Layer::Composited);
+    // tryGetChunk + pin: an empty pin while the chunk is pending
+    Pin tryPin(int cx, int cy, Layer need = Layer::Composited);
+    // Shadow halo of a pinned chunk (Chunk::halo): filled once from the chunks before it along
+    // J, then patched by edits. nullptr while one of them is still generating (it is queued).
+    const int16_t* halo(const Pin& p);
+    // View focus used to prioritize queued requests (nearest to center first, Chebyshev).
+    // Queued requests farther than radius+1 from the center are cancelled (along -J, past the
+    // reach of the visible chunks' shadow halos).
+    void setViewFocus(int ccx, int ccy, int radius);
+    // Moves finished chunks into the cache and commits edits older than cfg::JOURNAL_COMMIT_SEC
+    // to the journal. Call once per frame from the render thread.
+    void pumpCompleted();
+    // Preview of a visible chunk still generating: its heights from the first
+    // cfg::CHUNK_PREVIEW_OCTAVES base octaves (edits applied, no mountain mask), row-major like
+    // Chunk::heightData, or nullptr. Published by pumpCompleted, dropped when the chunk arrives.
+    const int16_t* previewHeights(int cx, int cy) const;
+
+    // Warm the cache with chunks expected to become visible soon. Replaces the previous
+    // prefetch set (stale queued prefetches are cancelled). Prefetches run after visible
+    // requests, never evict chunks drawn in the last frame, and are capped by the budget.
+    void prefetch(const std::vector<ChunkKey>& keys);
+    void setPrefetchBudget(int chunks) { _prefetchBudget = chunks; }
+    int prefetchBudget() const { return _prefetchBudget; }
+
+    // Resident memory budget in bytes (chunk layers + per-entry bookkeeping), shared by every
+    // world kept in cache. The number of cached chunks follows from it; chunks used this frame
+    // or the last one, and pinned chunks, are never evicted, so they may exceed the budget.
+    // Lowering it evicts right away.
+    void setCacheBudget(size_t bytes);
+    size_t cacheBudget() const { return _cacheBudget; }
+    struct CacheStats {
+        size_t bytes = 0;      // resident now
+        size_t highWater = 0;  // peak resident bytes since start (or resetHighWater)
+        size_t budget = 0;
+        size_t chunks = 0;     // resident chunk count
+    };
+    CacheStats cacheStats() const { return CacheStats{_cacheBytes, _cacheHighWater, _cacheBudget, _cache.size()}; }
+    void resetHighWater() { _cacheHighWater = _cacheBytes; }
+
+    // Resolution levels for zoomed-out views: level l samples every levelStride(l)-th vertex of
+    // the chunk grid, levelSide(l)^2 heights row-major (level 0 is the chunk itself).
+    static int levelStride(int level) { return cfg::CHUNK_LOD_STRIDES[level]; }
+    static int levelSide(int level) { return cfg::CHUNK_SIZE / levelStride(level) + 1; }
+    // Composited heights of chunk (cx, cy) at a coarse level (> 0), or nullptr if not built.
+    // Exact (sampled from the full chunk) when that one is resident; otherwise generated at the
+    // level's stride without the sub-stride octaves, then upgraded in place to the exact samples
+    // once the full chunk is resident. Valid until the next buildLevel, edit or world change.
+    const int16_t* levelHeights(int cx, int cy, int level);
+    // Builds the missing level chunks among keys, in order: sampled from resident full chunks,
+    // else generated (at most maxNew) on the worker pool and the calling thread. They have their
+    // own byte budget (cfg::CHUNK_LOD_CACHE_BYTES); entries read this frame or the last stay.
+    // Returns the number built.
+    int buildLevel(const std::vector<ChunkKey>& keys, int level, int maxNew);
+    size_t levelCacheBytes() const { return _levelBytes; }
+
+    // Second tier: evicted chunks kept compressed (cfg::CHUNK_TIER_BYTES), restored on revisit
+    void setTierBudget(size_t bytes) { _tier.setBudget(bytes); }
+    CompressedChunkCache::Stats tierStats() const { return _tier.stats(); }
 
     // Editing APIs (world coordinates in tile intersections)
-    void applyDeltaAt(int I, int J, int delta);
-    void applySetAt(int I, int J, int value);
+    void applyDeltaAt(int I, int J, int delta) { editRegion(I, J, I, J, EditOp::Add, delta); }
+    void applySetAt(int I, int J, int value) { editRegion(I, J, I, J, EditOp::Set, value); }
 
-    // Clears cache (persists dirty chunks first)
+    // Region edits over the vertex rectangle [I0,I1] x [J0,J1] (inclusive). Each touched chunk
+    // is resolved once and edited over its local subrange; vertices on shared chunk edges are
+    // mirrored into every chunk holding them. mask (optional) selects vertices, row-major over
+    // the rectangle: mask[(I - I0) * (J1 - J0 + 1) + (J - J0)]. Results are clamped to
+    // [MIN_ELEV, MAX_ELEV] and journaled.
+    enum class EditOp {
+        Add,        // height + value
+        AddToEdits, // (edited ? height : sea level 0) + value (water-only view)
+        Set,        // value (flatten to height)
+    };
+    void editRegion(int I0, int J0, int I1, int J1, EditOp op, int value, const uint8_t* mask = nullptr);
+    // Custom kernel: int kernel(int I, int J, int height, bool edited) -> new height.
+    // height is read from view: Layer::Overrides passes the water view (edit or 0) and
+    // generates no terrain; anything else passes the composited height.
+    template <typename Kernel>
+    void editRegionWith(int I0, int J0, int I1, int J1, Kernel&& kernel, const uint8_t* mask = nullptr,
+                        Layer view = Layer::Composited) {
+        auto call = [](void* ctx, int I, int J, int h, bool edited) {
+            return (*static_cast<std::remove_reference_t<Kernel>*>(ctx))(I, J, h, edited);
+        };
+        editRegionImpl(I0, J0, I1, J1, call, &kernel, mask, view != Layer::Overrides);
+    }
+    // Appends the edits made since the last commit to the journal as one record (end of a stroke)
+    void commitEdits() { _journal.commit(); }
+
+    // Bulk read of the vertex rectangle [I0,I1] x [J0,J1] (inclusive, any sign) into
+    // out[(I - I0) * stride + (J - J0)] (stride 0 = J1 - J0 + 1), chunk by chunk.
+    // Layer::Overrides never generates terrain.
+    // Resident chunks are read in place without touching their recency. Missing ones are
+    // restored from the compressed tier or built into scratch storage; at most cacheNew of
+    // them are kept in the cache, so a large bake cannot evict the visible set.
+    void readRegion(int I0, int J0, int I1, int J1, Layer layer, int* out, size_t stride = 0, int cacheNew = 0);
+
+    // Clears cache (edits are committed to the journal first)
     void clear();
+    // Blocks until every edit is in the journal and every queued region write is on disk
+    void flush() { _journal.commit(); _journal.waitCompaction(); _flusher.flush(); }
+
+    // Chunk storage recycling counters (evicted chunks feed the next generations)
+    ChunkPool::Stats poolStats() { return _chunkPool.stats(); }
 
     // Reset all user overrides for the current world (seed/continents):
-    // - Deletes persisted override files under maps/seed_<seed>[_cont]
-    // - Clears in-memory overrides and cache WITHOUT saving
+    // - Deletes the journal and region files under maps/seed_<seed>[_cont]
+    // - Drops the cached chunks of every world saved there WITHOUT saving (other worlds stay)
     void resetOverrides();
 
 private:
-    Mode _mode;
-    uint32_t _seed;
-    bool _continents = false;
-    struct Entry { Chunk ch; bool dirty = false; std::list<ChunkKey>::iterator it; };
-    std::unordered_map<ChunkKey, Entry, ChunkKeyHash> _cache;
-    std::list<ChunkKey> _lru; // most-recent at front
-
-    void generateChunk(Chunk& out, int cx, int cy);
-    // Persistence helpers
-    std::string chunkPath(int cx, int cy) const;
-    void ensureDir() const;
-    void loadOverrides(Chunk& ch, int cx, int cy);
-    void saveOverrides(const Chunk& ch, int cx, int cy);
+    // Everything generation depends on; copied into worker jobs
+    struct World {
+        Mode mode = Mode::Empty;
+        uint32_t seed = 0;
+        bool continents = false;
+        std::string dir = "maps/seed_0"; // persistence directory, kept in sync by worldDir()
+    };
+    World _world;                // current world, also _worlds[_worldId]
+    std::vector<World> _worlds;  // every world selected so far; the index tags its cached chunks
+    uint32_t _worldId = 0;
+    bool _worldEdited = false;   // edits made since the current world was selected
+    WorldChunkKey wk(const ChunkKey& key) const { return WorldChunkKey{key, _worldId}; }
+    // Makes w current (registered on first use); its cached chunks become visible again
+    void selectWorld(const World& w);
+    // Drops, without saving, the cached chunks of the worlds persisted in dir (except one)
+    void dropWorlds(const std::string& dir, uint32_t except);
+    ChunkPool _chunkPool; // before every container of chunks: outlives their storage
+    struct Entry {
+        explicit Entry(Chunk&& c) : ch(std::move(c)) {}
+        Chunk ch;
+        bool prefetched = false;   // generated ahead of time, not requested yet
+        uint32_t lastFrame = 0;    // frame of last access (visible-set protection)
+        size_t bytes = 0;          // accounted against the cache budget
+        int pins = 0;              // live Pin handles: never evicted while > 0
+        uint64_t serial = 0;       // insertion number, matched by pins on release
+    };
+    // Initial slot capacity for the default budget; grows when the visible set needs more
+    ClockCache<WorldChunkKey, Entry, WorldChunkKeyHash> _cache{cfg::CHUNK_CACHE_BYTES / (ChunkPool::BLOCK_BYTES + sizeof(Entry))};
+    size_t _cacheBudget = cfg::CHUNK_CACHE_BYTES;
+    size_t _cacheBytes = 0;
+    size_t _cacheHighWater = 0;
+    CompressedChunkCache _tier{cfg::CHUNK_TIER_BYTES};
+    uint32_t _frame = 1;      // advanced by pumpCompleted
+    int _prefetchBudget = cfg::PREFETCH_MAX_CHUNKS;
+    int _prefetchResident = 0;
+
+    // Inserts a freshly built chunk after making room under the budget (edits live in the journal)
+    Entry& insertEntry(const ChunkKey& key, Chunk&& ch);
+    // Evicts unpinned CLOCK victims outside the visible set until bytes more fit in the
+    // budget; false if the visible and pinned sets alone leave no room
+    bool makeRoom(size_t bytes);
+    // The one acquisition path: resident entry for key, else restored from the tier, else
+    // generated with its persisted overrides loaded (edits are journaled when made, so an
+    // evicted chunk never holds unsaved data). Without heights, only the edits are loaded.
+    Entry& acquire(const ChunkKey& key, bool heights = true);
+    // Non-blocking variant: queues generation and returns nullptr when nothing is at hand
+    Entry* tryAcquire(const ChunkKey& key, bool heights);
+    // Generates the heights of a resident chunk loaded without them
+    void materialize(const ChunkKey& key, Entry& e);
+    // Re-reads an entry's size after its layers changed
+    void reaccount(Entry& e);
+    Pin makePin(const ChunkKey& key, Entry& e);
+    void unpin(const WorldChunkKey& key, uint64_t serial);
+    uint64_t _nextSerial = 1;
+    using EditFn = int (*)(void* ctx, int I, int J, int height, bool edited);
+    void editRegionImpl(int I0, int J0, int I1, int J1, EditFn fn, void* ctx, const uint8_t* mask, bool heights);
+    std::vector<int> _editValues; // scratch: new values over the edited rectangle
+    std::vector<int> _editRow;    // scratch: override values of one row (INT_MIN = not edited)
+    // Drops an entry from the resident cache into the compressed tier
+    void evict(const WorldChunkKey& key);
+    // Drops an entry from the resident cache (nothing kept)
+    void erase(const WorldChunkKey& key);
+    static size_t entryBytes(const Chunk& ch) { return ch.bytes() + sizeof(Entry); }
+    void dropCache() { _cache.clear(); _tier.clear(); _cacheBytes = 0; _prefetchResident = 0; _levelCache.clear(); _levelBytes = 0; }
+    // Resident entry marked used this frame (no longer a pending prefetch), or nullptr
+    Entry* touch(const ChunkKey& key);
+
+    static void generateChunk(Chunk& out, int cx, int cy, const World& w);
+    // Terrain heights every step vertices: (CHUNK_SIZE/step + 1)^2, row-major. step 1 is the
+    // chunk's generated layer; larger steps drop the octaves finer than the sample spacing.
+    static void generateTerrain(int16_t* out, int cx, int cy, int step, const World& w);
+    // Its passes: base fbm octaves [first, last) added to the running sums in acc, then the
+    // heights from the finished base (the warped mountain-chain mask and the rare peaks)
+    static void baseOctaves(float* acc, int cx, int cy, int step, int first, int last, const World& w);
+    static void composeTerrain(int16_t* out, const float* base, int cx, int cy, int step, const World& w);
+    static float baseFreq(const World& w);
+    static float seaOffset(const World& w);
+
+    // ---- Coarse resolution levels (render thread only) ----
+    struct LevelEntry {
+        std::vector<int16_t> heights; // levelSide^2, row-major
+        bool exact = false;           // sampled from the full chunk (else generated, fewer octaves)
+        uint32_t lastFrame = 0;
+    };
+    ClockCache<LevelChunkKey, LevelEntry, LevelChunkKeyHash> _levelCache{1024};
+    size_t _levelBytes = 0;
+    static size_t levelBytes(int level) { return (size_t)levelSide(level) * levelSide(level) * sizeof(int16_t) + sizeof(LevelEntry); }
+    // Samples a level from a chunk's composited heights
+    static void sampleLevel(const int16_t* full, int level, int16_t* out);
+    // Drops every level of one chunk (its edits changed) or of the given worlds
+    void eraseLevels(const WorldChunkKey& key);
+    void eraseLevelWorlds(const std::string& dir, uint32_t except);
+    // Persistence helpers (overrides live in region files plus the edit journal of the world directory)
+    static std::string worldDir(const World& w);
+    void loadOverrides(Chunk& ch, int cx, int cy, const World& w);
+
+    // ---- Asynchronous generation (guarded by _reqMtx) ----
+    // Visible requests run in two passes: the low base octaves first (published as a preview),
+    // then the finer octaves and the mountain mask added to the kept sums. Every first pass
+    // runs before any second one; the chunk matches a single-pass one bit for bit.
+    struct Staged {
+        explicit Staged(ChunkPool& pool) : ch(pool) {}
+        Chunk ch;                // persisted overrides, loaded by the first pass
+        std::vector<float> base; // base fbm sums of octaves [0, CHUNK_PREVIEW_OCTAVES)
+    };
+    struct Request { uint64_t ticket; bool prefetch; std::shared_ptr<Staged> staged; }; // staged: first pass done
+    struct Result { ChunkKey key; Request req; Chunk ch; };
+    struct Preview { ChunkKey key; uint64_t ticket; std::vector<int16_t> heights; };
+    // First pass of a staged request: fills s (overrides are loaded by the caller) and out
+    // (ChunkPool::VERTS preview heights); the second one generates the chunk's heights into out
+    static void previewChunk(Staged& s, int16_t* out, int cx, int cy, const World& w);
+    static void refineChunk(Staged& s, Chunk& out, int cx, int cy, const World& w);
+    std::mutex _reqMtx;
+    std::condition_variable _idleCv;
+    World _jobWorld;                                                 // world snapshot for workers
+    std::unordered_map<ChunkKey, Request, ChunkKeyHash> _queued;     // waiting
+    std::unordered_map<ChunkKey, Request, ChunkKeyHash> _inflight;   // running
+    std::vector<Result> _done;                                       // finished, not yet cached
+    std::vector<Preview> _previewsDone;                              // first passes, not yet published
+    uint64_t _nextTicket = 1;
+    int _running = 0;
+    int _focusCx = 0, _focusCy = 0;
+
+    std::unordered_map<ChunkKey, std::vector<int16_t>, ChunkKeyHash> _previews; // render thread only
+
+    void runNextRequest();                // worker side: generate the best queued request
+    void cancelRequest(const ChunkKey& key);
+    void dropRequests();                  // forget all requests (world changed)
+    void waitWorkersIdle();
+
+    RegionStore _regions;
+    WriteBehind _flusher; // after _regions: drains into it on destruction
+    EditJournal _journal; // after _flusher: its compactor queues region writes
+    ThreadPool _pool; // declared last: joined before the members above are destroyed
 };
@@ -0,0 +1,87 @@
+#include "chunkstore.hpp"
+#include "mmapfile.hpp"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+namespace chunkstore {
+namespace {
+    const char MAGIC[4] = {'M', 'W', 'C', 'O'};
+
+    inline void put16(std::vector<uint8_t>& b, size_t at, uint16_t v) { b[at] = (uint8_t)v; b[at + 1] = (uint8_t)(v >> 8); }
+    inline void put32(std::vector<uint8_t>& b, size_t at, uint32_t v) { for (int k = 0; k < 4; ++k) b[at + k] = (uint8_t)(v >> (8 * k)); }
+    inline uint16_t get16(const uint8_t* p) { return (uint16_t)(p[0] | (p[1] << 8)); }
+    inline uint32_t get32(const uint8_t* p) { return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24); }
+    inline int clampElev(int v) { return std::max(cfg::MIN_ELEV, std::min(cfg::MAX_ELEV, v)); }
+}
+
+void encode(const Chunk& ch, std::vector<uint8_t>& out) {
+    out.clear();
+    const uint32_t count = (uint32_t)ch.overrides().count();
+    if (count == 0) return;
+    out.assign(HEADER_SIZE + MASK_BYTES + 2u * count, 0);
+    std::memcpy(out.data(), MAGIC, 4);
+    put16(out, 4, VERSION);
+    put16(out, 6, (uint16_t)SIDE);
+    put32(out, 8, count);
+    uint8_t* mask = out.data() + HEADER_SIZE;
+    size_t vp = HEADER_SIZE + MASK_BYTES;
+    ch.overrides().forEach([&](int k, int v){
+        mask[k >> 3] |= (uint8_t)(1u << (k & 7));
+        put16(out, vp, (uint16_t)(int16_t)v);
+        vp += 2;
+    });
+}
+
+bool decode(const uint8_t* data, size_t size, Chunk& ch) {
+    if (!data || size < HEADER_SIZE + MASK_BYTES) return false;
+    if (std::memcmp(data, MAGIC, 4) != 0) return false;
+    if (get16(data + 4) != VERSION || get16(data + 6) != SIDE) return false;
+    uint32_t count = get32(data + 8);
+    if (size < HEADER_SIZE + MASK_BYTES + 2ull * count) return false;
+    const uint8_t* mask = data + HEADER_SIZE;
+    const uint8_t* vals = mask + MASK_BYTES;
+    const int N = SIDE * SIDE;
+    uint32_t seen = 0;
+    for (size_t b = 0; b < MASK_BYTES; ++b) {
+        unsigned bits = mask[b];
+        while (bits) {
+            int bit = 0;
+            while (!((bits >> bit) & 1u)) ++bit;
+            bits &= bits - 1;
+            int k = (int)(b * 8) + bit;
+            if (k >= N || seen >= count) return false;
+            ch.setOverride(k, clampElev((int16_t)get16(vals + 2 * seen)));
+            ++seen;
+        }
+    }
+    return seen == count;
+}
+
+bool loadBinary(const std::string& path, Chunk& ch) {
+    MappedFile mf;
+    if (!mf.open(path)) return false;
+    return decode(mf.data(), mf.size(), ch);
+}
+
+bool loadCsv(const std::string& path, Chunk& ch) {
+    std::ifstream in(path);
+    if (!in) return false;
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.empty()) continue;
+        std::stringstream ss(line);
+        std::string a,b,c;
+        if (!std::getline(ss, a, ',')) continue;
+        if (!std::getline(ss, b, ',')) continue;
+        if (!std::getline(ss, c, ',')) continue;
+        int i = 0, j = 0, v = 0;
+        try { i = std::stoi(a); j = std::stoi(b); v = std::stoi(c); } catch (...) { continue; }
+        if (i < 0 || j < 0 || i >= SIDE || j >= SIDE) continue;
+        ch.setOverride(Chunk::idx(i, j), clampElev(v)); // apply on top of generated
+    }
+    return true;
+}
+
+}
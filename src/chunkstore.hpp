@@ -0,0 +1,27 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "chunks.hpp"
+
+// Binary chunk-override blob, little-endian (stored in region files, see regionfile.hpp;
+// older builds wrote one blob per chunk as cX_Y.mwc):
+//   header  16 bytes: magic "MWCO", u16 version, u16 side (CHUNK_SIZE+1), u32 count, u32 reserved
+//   mask    ceil(side*side/8) bytes, bit k set <=> vertex k (Chunk::idx order) is overridden
+//   values  count x i16, in increasing vertex order
+// Blobs are decoded in place: no text parsing on chunk load.
+namespace chunkstore {
+    constexpr uint16_t VERSION = 1;
+    constexpr size_t HEADER_SIZE = 16;
+    constexpr int SIDE = cfg::CHUNK_SIZE + 1;
+    constexpr size_t MASK_BYTES = (size_t)(SIDE * SIDE + 7) / 8;
+
+    // Serialize the override layer of ch (empty output when there are no overrides)
+    void encode(const Chunk& ch, std::vector<uint8_t>& out);
+    // Apply an encoded blob to ch (overrides, mask and heights). False on malformed data.
+    bool decode(const uint8_t* data, size_t size, Chunk& ch);
+
+    // Legacy per-chunk files, read for import only
+    bool loadBinary(const std::string& path, Chunk& ch);  // cX_Y.mwc (mmapped)
+    bool loadCsv(const std::string& path, Chunk& ch);     // cX_Y.csv: one "i,j,value" line per vertex
+}
@@ -0,0 +1,140 @@
+#include "chunktier.hpp"
+#include "chunks.hpp"
+#include "chunkstore.hpp"
+
+namespace {
+    constexpr int SIDE = cfg::CHUNK_SIZE + 1;
+
+    inline int predict(const int16_t* h, int i, int j) {
+        const int k = i * SIDE + j;
+        if (i == 0) return j == 0 ? 0 : h[k - 1];
+        if (j == 0) return h[k - SIDE];
+        return h[k - 1] + h[k - SIDE] - h[k - SIDE - 1];
+    }
+
+    // Leading byte of a compressed chunk: how its heights are stored
+    enum : uint8_t { NO_HEIGHTS = 0, PREDICTED_HEIGHTS = 1, UNIFORM_HEIGHTS = 2 };
+
+    inline uint32_t zigzag(int v) { return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31); }
+    inline int unzigzag(uint32_t z) { return (int)(z >> 1) ^ -(int)(z & 1); }
+    inline void putVarint(std::vector<uint8_t>& out, uint32_t z) {
+        while (z >= 0x80) { out.push_back((uint8_t)(z | 0x80)); z >>= 7; }
+        out.push_back((uint8_t)z);
+    }
+    inline bool getVarint(const uint8_t* data, size_t size, size_t& p, uint32_t& z) {
+        z = 0;
+        for (int shift = 0;; shift += 7) {
+            if (p >= size || shift > 28) return false;
+            uint8_t b = data[p++];
+            z |= (uint32_t)(b & 0x7F) << shift;
+            if (!(b & 0x80)) return true;
+        }
+    }
+}
+
+void CompressedChunkCache::compress(const Chunk& ch, std::vector<uint8_t>& out) {
+    out.clear();
+    out.reserve(SIDE * SIDE + 64);
+    const int16_t* h = ch.heightData();
+    if (!h) {
+        out.push_back(NO_HEIGHTS);
+    } else if (ch.shared()) {
+        out.push_back(UNIFORM_HEIGHTS);
+        putVarint(out, zigzag(h[0]));
+    } else {
+        out.push_back(PREDICTED_HEIGHTS);
+        for (int i = 0; i < SIDE; ++i)
+            for (int j = 0; j < SIDE; ++j) putVarint(out, zigzag(h[i * SIDE + j] - predict(h, i, j)));
+    }
+    std::vector<uint8_t> ov;
+    chunkstore::encode(ch, ov);
+    out.insert(out.end(), ov.begin(), ov.end());
+}
+
+bool CompressedChunkCache::decompress(const uint8_t* data, size_t size, Chunk& out) {
+    if (size == 0) return false;
+    size_t p = 1;
+    uint32_t z = 0;
+    switch (data[0]) {
+    case NO_HEIGHTS:
+        break;
+    case UNIFORM_HEIGHTS:
+        if (!getVarint(data, size, p, z)) return false;
+        out.makeUniform(unzigzag(z));
+        break;
+    case PREDICTED_HEIGHTS: {
+        int16_t* h = out.writableHeights();
+        for (int i = 0; i < SIDE; ++i) {
+            for (int j = 0; j < SIDE; ++j) {
+                if (!getVarint(data, size, p, z)) return false;
+                h[i * SIDE + j] = (int16_t)(predict(h, i, j) + unzigzag(z));
+            }
+        }
+        break;
+    }
+    default:
+        return false;
+    }
+    return p == size || chunkstore::decode(data + p, size - p, out);
+}
+
+void CompressedChunkCache::put(const WorldChunkKey& key, const Chunk& ch) {
+    erase(key);
+    if (_budget == 0) return;
+    compress(ch, _scratch);
+    std::vector<uint8_t> blob(_scratch.begin(), _scratch.end()); // exact-size copy
+    size_t bytes = blobBytes(blob);
+    if (bytes > _budget) return;
+    shrinkTo(_budget - bytes);
+    if (_cache.full()) _cache.grow(_cache.capacity() * 2);
+    _cache.insert(key, std::move(blob));
+    _bytes += bytes;
+}
+
+bool CompressedChunkCache::take(const WorldChunkKey& key, Chunk& out) {
+    std::vector<uint8_t>* blob = _cache.find(key);
+    if (!blob) { ++_misses; return false; }
+    bool ok = decompress(blob->data(), blob->size(), out);
+    erase(key);
+    if (!ok) { ++_misses; return false; }
+    ++_hits;
+    return true;
+}
+
+bool CompressedChunkCache::peek(const WorldChunkKey& key, Chunk& out) {
+    std::vector<uint8_t>* blob = _cache.get(key);
+    if (!blob || !decompress(blob->data(), blob->size(), out)) { ++_misses; return false; }
+    ++_hits;
+    return true;
+}
+
+void CompressedChunkCache::erase(const WorldChunkKey& key) {
+    std::vector<uint8_t>* blob = _cache.find(key);
+    if (!blob) return;
+    _bytes -= blobBytes(*blob);
+    _cache.erase(key);
+}
+
+void CompressedChunkCache::eraseWorld(uint32_t world) {
+    std::vector<WorldChunkKey> keys;
+    _cache.forEach([&](const WorldChunkKey& k, std::vector<uint8_t>&){ if (k.world == world) keys.push_back(k); });
+    for (const WorldChunkKey& k : keys) erase(k);
+}
+
+void CompressedChunkCache::clear() {
+    _cache.clear();
+    _bytes = 0;
+}
+
+void CompressedChunkCache::setBudget(size_t bytes) {
+    _budget = bytes;
+    shrinkTo(bytes);
+}
+
+void CompressedChunkCache::shrinkTo(size_t budget) {
+    while (_bytes > budget) {
+        const WorldChunkKey* victim = _cache.victim();
+        if (!victim) break;
+        erase(*victim);
+    }
+}
@@ -0,0 +1,56 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "config.hpp"
+#include "chunkkey.hpp"
+#include "chunkcache.hpp"
+
+struct Chunk;
+
+// Second cache tier: chunks evicted from the resident cache are kept compressed so that
+// revisiting them costs a decode instead of the full noise stack. Entries are taken out on
+// a hit (the resident copy becomes the only one) and re-compressed on the next eviction.
+// Encoding: one byte telling how heights are stored (absent; uniform, as one zigzag varint;
+// or zigzag varints of the residual against a planar predictor, left + up - upleft),
+// followed by the override layer in chunkstore format.
+// Single-threaded (render thread); budgeted in bytes with CLOCK eviction.
+class CompressedChunkCache {
+public:
+    struct Stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        size_t bytes = 0;   // compressed bytes held
+        size_t budget = 0;
+        size_t chunks = 0;
+    };
+
+    explicit CompressedChunkCache(size_t budgetBytes) : _budget(budgetBytes) {}
+
+    void put(const WorldChunkKey& key, const Chunk& ch);
+    // Restores key into out (a cleared chunk) and drops it from the tier; false on miss
+    bool take(const WorldChunkKey& key, Chunk& out);
+    // Same, but the compressed copy stays in the tier (read-only sampling)
+    bool peek(const WorldChunkKey& key, Chunk& out);
+    bool contains(const WorldChunkKey& key) { return _cache.find(key) != nullptr; }
+    void erase(const WorldChunkKey& key);
+    // Drops every chunk of one world
+    void eraseWorld(uint32_t world);
+    void clear();
+
+    void setBudget(size_t bytes);
+    Stats stats() const { return Stats{_hits, _misses, _bytes, _budget, _cache.size()}; }
+
+    static void compress(const Chunk& ch, std::vector<uint8_t>& out);
+    static bool decompress(const uint8_t* data, size_t size, Chunk& out);
+
+private:
+    ClockCache<WorldChunkKey, std::vector<uint8_t>, WorldChunkKeyHash> _cache{256};
+    size_t _budget;
+    size_t _bytes = 0;
+    uint64_t _hits = 0;
+    uint64_t _misses = 0;
+    std::vector<uint8_t> _scratch;
+
+    static size_t blobBytes(const std::vector<uint8_t>& b) { return b.capacity() + sizeof(b); }
+    void shrinkTo(size_t budget);
+};
@@ -1,9 +1,34 @@
 #pragma once
+#include <cstddef>
 
 namespace cfg {
     // Chunked world configuration
     constexpr int CHUNK_SIZE = 60;           // tiles per chunk side (chunk grid is (CHUNK_SIZE+1)^2 vertices)
-    constexpr int MAX_CACHED_CHUNKS = 121;   // simple LRU budget (e.g., 11x11 visible)
+    constexpr size_t CHUNK_CACHE_BYTES = 32u << 20; // default resident chunk memory budget (visible chunks may exceed it)
+    constexpr size_t CHUNK_TIER_BYTES = 16u << 20;  // compressed copies of evicted chunks (second cache tier)
+    constexpr int SHADOW_STEPS = 96;         // shadow march length in vertices, toward the light (-J)
+    constexpr int SHADOW_HALO = SHADOW_STEPS; // neighbour heights kept before each chunk row along J (0 = none)
+    constexpr int CHUNK_POOL_MAX_FREE = 64;  // spare chunk storage blocks kept for reuse
+    constexpr int CHUNK_WORKER_THREADS = 0;  // background chunk generators (0 = hardware threads - 1)
+    // Resolution levels for zoomed-out views: vertex stride per level (level 0 = full chunk);
+    // each divides CHUNK_SIZE so a level's samples land on chunk vertices, edges included
+    constexpr int CHUNK_LOD_LEVELS = 4;
+    constexpr int CHUNK_LOD_STRIDES[CHUNK_LOD_LEVELS] = {1, 2, 4, 10};
+    constexpr size_t CHUNK_LOD_CACHE_BYTES = 8u << 20; // coarse level heights, cached apart from full chunks
+    constexpr int CHUNK_LOD_BUILD_MAX = 256;  // coarse chunks built per frame (a parallel batch)
+    constexpr float CHUNK_LOD_QUAD_PX = 14.f; // zoomed out, draw the coarsest level whose quads stay under this size
+    constexpr int CHUNK_LOD_MAX_RADIUS = 40;  // chunk radius cap at coarse levels (full chunks: 10)
+    constexpr float CHUNK_LOD_MAX_ZOOM = 24.f; // zoom-out limit in procedural mode (view scale)
+    constexpr int CHUNK_BASE_OCTAVES = 5;     // base terrain fbm octaves of a chunk
+    constexpr int CHUNK_PREVIEW_OCTAVES = 2;  // base octaves of the preview shown while the rest generates (0 = none)
+    constexpr int TERRAIN_BAND_ROWS = 8;     // rows per task when terrain::generateMap runs on a pool
+    constexpr float PREFETCH_HORIZON_SEC = 0.6f; // how far ahead camera motion is extrapolated
+    constexpr int PREFETCH_MAX_CHUNKS = 48;      // cap on prefetched-but-not-yet-visible chunks (queued + resident)
+    constexpr int REGION_CHUNKS = 32;        // region files hold REGION_CHUNKS x REGION_CHUNKS chunks
+    constexpr int REGION_OPEN_FILES = 16;    // open region file handles kept (LRU)
+    constexpr int FLUSH_QUEUE_MAX = 64;      // unwritten chunk snapshots before edits block (write-behind)
+    constexpr float JOURNAL_COMMIT_SEC = 0.5f;        // uncommitted edits older than this are appended to the journal
+    constexpr int JOURNAL_COMPACT_BYTES = 1 << 20;    // journal size that triggers merging it into region files
 
     constexpr int GRID = 300;                // 300 tiles per side
     constexpr float TILE_W = 32.f;           // visual diamond width in pixels
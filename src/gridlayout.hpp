@@ -0,0 +1,83 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// Vertex orders for an N x N layer (N = CHUNK_SIZE + 1 for chunk layers). Each exposes
+//   SIDE                  N
+//   SLOTS                 storage size (tiled orders pad to whole tiles)
+//   index(i, j)           storage slot of vertex (i, j)
+//   forRow(i, j0, j1, f)  f(j, slot) for j in [j0, j1], in increasing j
+// Chunk storage is fixed row-major by design (Chunk::Layout): the bulk paths (readRegion,
+// editRegion, chunkstore, the compressed tier) and the renderer copy and stream whole rows
+// and are not written against Layout, so Chunk::Layout is not a switch. Tiled and Morton
+// exist for the layout bench, which measured row-major fastest at every chunk size tried.
+namespace layout {
+
+template <int N>
+struct RowMajor {
+    static constexpr int SIDE = N;
+    static constexpr size_t SLOTS = (size_t)N * N;
+    static constexpr int index(int i, int j) { return i * N + j; }
+    template <typename F>
+    static void forRow(int i, int j0, int j1, F&& f) {
+        for (int j = j0, k = index(i, j0); j <= j1; ++j, ++k) f(j, k);
+    }
+};
+
+// T x T tiles, row-major inside a tile and tiles row-major: a 2x2 or diagonal neighbourhood
+// stays within one or two tiles instead of spanning rows N apart
+template <int N, int T = 8>
+struct Tiled {
+    static_assert((T & (T - 1)) == 0, "tile side must be a power of two");
+    static constexpr int SIDE = N;
+    static constexpr int TILES = (N + T - 1) / T;
+    static constexpr size_t SLOTS = (size_t)TILES * TILES * T * T;
+    static constexpr int index(int i, int j) {
+        return ((i / T) * TILES + j / T) * (T * T) + (i % T) * T + (j % T);
+    }
+    template <typename F>
+    static void forRow(int i, int j0, int j1, F&& f) {
+        // Contiguous within a tile, one index computation per tile crossed
+        for (int j = j0; j <= j1; ) {
+            const int end = j1 < (j | (T - 1)) ? j1 : (j | (T - 1));
+            for (int k = index(i, j); j <= end; ++j, ++k) f(j, k);
+        }
+    }
+};
+
+// Z-order (Morton) over the next power-of-two side: bits of j at even positions, of i at odd
+template <int N>
+struct Morton {
+    static constexpr int pow2(int v) { int p = 1; while (p < v) p <<= 1; return p; }
+    static constexpr int SIDE = N;
+    static constexpr size_t SLOTS = (size_t)pow2(N) * pow2(N);
+    static constexpr uint32_t spread(uint32_t v) {
+        v &= 0xFFFFu;
+        v = (v | (v << 8)) & 0x00FF00FFu;
+        v = (v | (v << 4)) & 0x0F0F0F0Fu;
+        v = (v | (v << 2)) & 0x33333333u;
+        v = (v | (v << 1)) & 0x55555555u;
+        return v;
+    }
+    static constexpr int index(int i, int j) { return (int)((spread((uint32_t)i) << 1) | spread((uint32_t)j)); }
+    template <typename F>
+    static void forRow(int i, int j0, int j1, F&& f) {
+        // Step j by a masked increment of its interleaved bits (carries skip the i bits)
+        const uint32_t hi = spread((uint32_t)i) << 1;
+        uint32_t lo = spread((uint32_t)j0);
+        for (int j = j0; j <= j1; ++j) {
+            f(j, (int)(hi | lo));
+            lo = ((lo | ~0x55555555u) + 1) & 0x55555555u;
+        }
+    }
+};
+
+// Shadow halo of a chunk layer: D vertices before each row along J, row-major; neighbour
+// vertex (i, j), j in [-D, -1], at index(i, j). Shared by Chunk::haloIdx and the renderer.
+template <int D>
+struct Halo {
+    static constexpr int DEPTH = D;
+    static constexpr int index(int i, int j) { return i * D + D + j; }
+};
+
+} // namespace layout
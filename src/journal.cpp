@@ -0,0 +1,248 @@
+#include "journal.hpp"
+#include "chunks.hpp"
+#include "chunkstore.hpp"
+#include "mmapfile.hpp"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+
+namespace fs = std::filesystem;
+
+namespace {
+    const char MAGIC[4] = {'M', 'W', 'J', 'L'};
+    constexpr uint16_t VERSION = 1;
+    constexpr size_t HEADER_SIZE = 8;
+    constexpr size_t RECORD_HEADER = 8; // u32 count, u32 checksum
+    constexpr size_t EDIT_BYTES = 10;   // i32 I, i32 J, i16 value
+
+    inline int floorDiv(int a, int b) { return (a >= 0) ? (a / b) : ((a - (b - 1)) / b); }
+    inline int64_t packIJ(int I, int J) { return (int64_t)((uint64_t)(uint32_t)I << 32 | (uint32_t)J); }
+    inline void put32(uint8_t* p, uint32_t v) { for (int k = 0; k < 4; ++k) p[k] = (uint8_t)(v >> (8 * k)); }
+    inline uint32_t get32(const uint8_t* p) { return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24); }
+    uint32_t fnv1a(const uint8_t* p, size_t n) {
+        uint32_t h = 2166136261u;
+        for (size_t k = 0; k < n; ++k) { h ^= p[k]; h *= 16777619u; }
+        return h;
+    }
+}
+
+EditJournal::~EditJournal() {
+    commit();
+    closeFile();
+    waitCompaction();
+}
+
+void EditJournal::open(const std::string& dir) {
+    if (dir == _dir) return;
+    commit();
+    closeFile();
+    waitCompaction();
+    Overlay current, interrupted;
+    // edits.mwj.old only survives a crash during compaction: finish that merge first
+    replay(dir + "/edits.mwj.old", interrupted);
+    uint64_t valid = replay(dir + "/edits.mwj", current);
+    {
+        std::lock_guard<std::mutex> lk(_mtx);
+        _dir = dir;
+        _overlay = std::move(current);
+        _compacting.reset();
+        if (!interrupted.empty()) _compacting = std::make_shared<const Overlay>(std::move(interrupted));
+    }
+    _batch.clear();
+    _fileBytes = valid;
+    std::error_code ec;
+    if (valid > 0 && fs::file_size(path(), ec) != valid) fs::resize_file(path(), valid, ec); // drop torn tail
+    if (_compacting) launchCompactor();
+    else fs::remove(oldPath(), ec);
+}
+
+void EditJournal::record(int I, int J, int value) {
+    if (_batch.empty()) _batchSince = std::chrono::steady_clock::now();
+    _batch[packIJ(I, J)] = value;
+    std::lock_guard<std::mutex> lk(_mtx);
+    addToOverlay(_overlay, I, J, value);
+}
+
+void EditJournal::commit() {
+    if (_batch.empty() || _dir.empty()) return;
+    if (!openForAppend()) return; // keep the batch, retry on next commit
+    std::vector<uint8_t> rec(RECORD_HEADER + EDIT_BYTES * _batch.size());
+    uint8_t* p = rec.data() + RECORD_HEADER;
+    for (const auto& kv : _batch) {
+        put32(p, (uint32_t)(kv.first >> 32));
+        put32(p + 4, (uint32_t)kv.first);
+        int16_t v = (int16_t)kv.second;
+        p[8] = (uint8_t)v; p[9] = (uint8_t)((uint16_t)v >> 8);
+        p += EDIT_BYTES;
+    }
+    put32(rec.data(), (uint32_t)_batch.size());
+    put32(rec.data() + 4, fnv1a(rec.data() + RECORD_HEADER, rec.size() - RECORD_HEADER));
+    // Synced, not just flushed: a committed record survives an OS crash or power loss too
+    if (std::fwrite(rec.data(), 1, rec.size(), _file) != rec.size() || std::fflush(_file) != 0 || !syncFile(_file)) {
+        closeFile(); // partial record: replay will stop before it
+        return;
+    }
+    _fileBytes += rec.size();
+    _batch.clear();
+    if (_fileBytes > (uint64_t)cfg::JOURNAL_COMPACT_BYTES) {
+        {
+            std::lock_guard<std::mutex> lk(_mtx);
+            if (_compacting) return; // one compaction at a time; the log keeps growing meanwhile
+        }
+        rotate();
+        launchCompactor();
+    }
+}
+
+void EditJournal::commitIfOlderThan(float maxAgeSec) {
+    if (_batch.empty()) return;
+    if (std::chrono::steady_clock::now() - _batchSince >= std::chrono::duration<float>(maxAgeSec)) commit();
+}
+
+void EditJournal::collect(const std::string& dir, int cx, int cy, std::vector<Edit>& out) {
+    out.clear();
+    std::lock_guard<std::mutex> lk(_mtx);
+    if (dir != _dir) return;
+    int64_t key = packIJ(cx, cy);
+    if (_compacting) {
+        auto it = _compacting->find(key);
+        if (it != _compacting->end()) out.insert(out.end(), it->second.begin(), it->second.end());
+    }
+    auto it = _overlay.find(key);
+    if (it != _overlay.end()) out.insert(out.end(), it->second.begin(), it->second.end());
+}
+
+void EditJournal::apply(const std::vector<Edit>& edits, Chunk& ch) {
+    for (const Edit& e : edits) ch.setOverride(e.k, e.v);
+}
+
+void EditJournal::discard() {
+    _batch.clear();
+    closeFile();
+    waitCompaction();
+    {
+        std::lock_guard<std::mutex> lk(_mtx);
+        _overlay.clear();
+        _compacting.reset();
+    }
+    _fileBytes = 0;
+    std::error_code ec;
+    fs::remove(path(), ec);
+    fs::remove(oldPath(), ec);
+}
+
+void EditJournal::waitCompaction() {
+    if (_compactor.joinable()) _compactor.join();
+}
+
+void EditJournal::addToOverlay(Overlay& ov, int I, int J, int value) {
+    // A vertex on a chunk border belongs to up to four chunks
+    const int S = cfg::CHUNK_SIZE;
+    int cx = floorDiv(I, S), cy = floorDiv(J, S);
+    int nx = (I == cx * S) ? 2 : 1;
+    int ny = (J == cy * S) ? 2 : 1;
+    for (int a = 0; a < nx; ++a) {
+        for (int b = 0; b < ny; ++b) {
+            int ecx = cx - a, ecy = cy - b;
+            int k = Chunk::idx(I - ecx * S, J - ecy * S);
+            ov[packIJ(ecx, ecy)].push_back(Edit{(uint16_t)k, (int16_t)value});
+        }
+    }
+}
+
+uint64_t EditJournal::replay(const std::string& file, Overlay& ov) {
+    std::FILE* f = std::fopen(file.c_str(), "rb");
+    if (!f) return 0;
+    uint8_t hdr[HEADER_SIZE];
+    if (std::fread(hdr, 1, HEADER_SIZE, f) != HEADER_SIZE || std::memcmp(hdr, MAGIC, 4) != 0
+        || (hdr[4] | (hdr[5] << 8)) != VERSION) {
+        std::fclose(f);
+        return 0;
+    }
+    uint64_t valid = HEADER_SIZE;
+    std::vector<uint8_t> payload;
+    for (;;) {
+        uint8_t rh[RECORD_HEADER];
+        if (std::fread(rh, 1, RECORD_HEADER, f) != RECORD_HEADER) break;
+        uint32_t count = get32(rh);
+        if (count == 0 || count > (1u << 24)) break;
+        payload.resize((size_t)count * EDIT_BYTES);
+        if (std::fread(payload.data(), 1, payload.size(), f) != payload.size()) break;
+        if (fnv1a(payload.data(), payload.size()) != get32(rh + 4)) break;
+        for (uint32_t e = 0; e < count; ++e) {
+            const uint8_t* p = payload.data() + (size_t)e * EDIT_BYTES;
+            int I = (int)get32(p);
+            int J = (int)get32(p + 4);
+            int v = (int16_t)(p[8] | (p[9] << 8));
+            addToOverlay(ov, I, J, std::max(cfg::MIN_ELEV, std::min(cfg::MAX_ELEV, v)));
+        }
+        valid += RECORD_HEADER + payload.size();
+    }
+    std::fclose(f);
+    return valid;
+}
+
+bool EditJournal::openForAppend() {
+    if (_file) return true;
+    std::error_code ec;
+    fs::create_directories(fs::path(_dir), ec);
+    _file = std::fopen(path().c_str(), "ab");
+    if (!_file) return false;
+    if (_fileBytes == 0) {
+        uint8_t hdr[HEADER_SIZE] = {0};
+        std::memcpy(hdr, MAGIC, 4);
+        hdr[4] = (uint8_t)VERSION; hdr[5] = (uint8_t)(VERSION >> 8);
+        if (std::fwrite(hdr, 1, HEADER_SIZE, _file) != HEADER_SIZE) { closeFile(); return false; }
+        _fileBytes = HEADER_SIZE;
+    }
+    return true;
+}
+
+void EditJournal::closeFile() {
+    if (_file) std::fclose(_file);
+    _file = nullptr;
+}
+
+void EditJournal::rotate() {
+    closeFile();
+    std::error_code ec;
+    fs::rename(path(), oldPath(), ec);
+    if (ec) return; // keep appending to the current file; retried on a later commit
+    {
+        std::lock_guard<std::mutex> lk(_mtx);
+        _compacting = std::make_shared<const Overlay>(std::move(_overlay));
+        _overlay.clear();
+    }
+    _fileBytes = 0;
+}
+
+void EditJournal::launchCompactor() {
+    waitCompaction();
+    std::shared_ptr<const Overlay> ov;
+    {
+        std::lock_guard<std::mutex> lk(_mtx);
+        ov = _compacting;
+    }
+    if (!ov) return;
+    std::string dir = _dir;
+    _compactor = std::thread([this, ov, dir]{
+        std::vector<uint8_t> blob;
+        for (const auto& kv : *ov) {
+            int cx = (int)(kv.first >> 32), cy = (int)(uint32_t)kv.first;
+            Chunk tmp;
+            WriteBehind::Blob snap;
+            if (_flusher.pending(dir, cx, cy, snap)) chunkstore::decode(snap->data(), snap->size(), tmp);
+            else _regions.load(dir, cx, cy, tmp);
+            apply(kv.second, tmp);
+            chunkstore::encode(tmp, blob);
+            _flusher.enqueue(dir, cx, cy, std::move(blob));
+            blob.clear();
+        }
+        // Only forget the rotated log once every merged chunk is on disk
+        _flusher.flush();
+        std::error_code ec;
+        fs::remove(fs::path(dir + "/edits.mwj.old"), ec);
+        std::lock_guard<std::mutex> lk(_mtx);
+        if (_compacting == ov) _compacting.reset();
+    });
+}
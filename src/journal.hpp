@@ -0,0 +1,80 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "config.hpp"
+#include "regionfile.hpp"
+#include "writebehind.hpp"
+
+// Append-only per-world edit journal (maps/seed_<seed>[_cont]/edits.mwj), little-endian:
+//   header  8 bytes: magic "MWJL", u16 version, u16 reserved
+//   record  u32 count, u32 FNV-1a checksum of the payload, then count x {i32 I, i32 J, i16 value}
+// One record per brush stroke (commit), fsynced before commit() returns. Replay stops at the
+// first torn or corrupt record, so a crash of the process or the OS loses at most the batch
+// that was being written. Edits stay in an in-memory overlay
+// (applied on top of region data when a chunk loads) until the journal grows past
+// cfg::JOURNAL_COMPACT_BYTES; it is then rotated to edits.mwj.old and merged into the region
+// files on a background thread.
+struct Chunk;
+
+class EditJournal {
+public:
+    EditJournal(RegionStore& regions, WriteBehind& flusher) : _regions(regions), _flusher(flusher) {}
+    ~EditJournal();
+    EditJournal(const EditJournal&) = delete;
+    EditJournal& operator=(const EditJournal&) = delete;
+
+    // Switches to the journal of dir (commits and closes the current one, replays the new one)
+    void open(const std::string& dir);
+    const std::string& dir() const { return _dir; }
+
+    // Records a world-vertex edit into the current batch
+    void record(int I, int J, int value);
+    // Appends the current batch as one record (no-op when empty)
+    void commit();
+    // Commits when the oldest uncommitted edit is older than maxAgeSec
+    void commitIfOlderThan(float maxAgeSec);
+
+    // Logged edits of one chunk, chunk-local vertex index k (Chunk::idx) -> value, in log order
+    struct Edit { uint16_t k; int16_t v; };
+    // Gather the edits of chunk (cx, cy) in dir. Call BEFORE reading the chunk's region data:
+    // a compaction finishing in between then only makes re-applying them redundant.
+    void collect(const std::string& dir, int cx, int cy, std::vector<Edit>& out);
+    static void apply(const std::vector<Edit>& edits, Chunk& ch);
+
+    // Forgets every edit of the current world and deletes its journal files
+    void discard();
+    // Waits for a running compaction (its region writes are queued to the flusher)
+    void waitCompaction();
+
+private:
+    using Overlay = std::unordered_map<int64_t, std::vector<Edit>>; // packed (cx,cy) -> edits
+
+    RegionStore& _regions;
+    WriteBehind& _flusher;
+    std::mutex _mtx;              // guards the overlays (workers read them while loading)
+    std::string _dir;
+    std::FILE* _file = nullptr;
+    uint64_t _fileBytes = 0;
+    Overlay _overlay;                         // edits logged since the last rotation
+    std::shared_ptr<const Overlay> _compacting; // rotated edits being merged into regions
+    std::unordered_map<int64_t, int> _batch;  // uncommitted: packed (I,J) -> value
+    std::chrono::steady_clock::time_point _batchSince;
+    std::thread _compactor;
+
+    std::string path() const { return _dir + "/edits.mwj"; }
+    std::string oldPath() const { return _dir + "/edits.mwj.old"; }
+    static void addToOverlay(Overlay& ov, int I, int J, int value);
+    // Loads the valid prefix of a journal file into ov; returns its length in bytes (0 if none)
+    static uint64_t replay(const std::string& file, Overlay& ov);
+    bool openForAppend();
+    void closeFile();
+    void rotate();          // current journal -> edits.mwj.old, overlay -> _compacting
+    void launchCompactor(); // merges _compacting into regions, then deletes edits.mwj.old
+};
@@ -26,6 +26,7 @@
 #include "terrain.hpp"
 #include "render.hpp"
 #include "chunks.hpp"
+#include "prefetch.hpp"
 
 // MyWorld - Isometric diamond tiles with elevation editing, camera pan+zoom
 // Grid: 20x20 tiles, each isometric tile nominal size 32x32 (diamond)
@@ -87,14 +88,20 @@ int main() {
     std::vector<int> heights((cfg::GRID + 1) * (cfg::GRID + 1), 0);
     auto idx = [](int i, int j) { return i * (cfg::GRID + 1) + j; };
 
-    // Terrain generation provided by terrain::generateMap
-    auto generateMap = [&](uint32_t seed){ terrain::generateMap(heights, seed); };
-
     // Chunked world manager (procedural mode)
     ChunkManager chunkMgr;
+    // Terrain generation provided by terrain::generateMap, in row bands on the chunk workers
+    auto generateMap = [&](uint32_t seed){ terrain::generateMap(heights, seed, &chunkMgr.workers()); };
+    ChunkPrefetcher prefetcher;   // warms chunks ahead of camera motion
+    std::vector<ChunkKey> prefetchKeys;
+    std::vector<ChunkKey> levelKeys; // visible chunks at the coarse level drawn this frame
+    std::vector<ChunkManager::Pin> framePins; // chunks drawn this frame, released at the next one
     bool proceduralMode = true;   // start with procedural active
     bool waterOnly = true;        // show only water until user generates
     uint32_t proceduralSeed = (uint32_t)std::rand();
+    // Largest view scale (most zoomed out): chunks zoom out further on coarse levels, which the
+    // water-only view (edits layer, full chunks within a small radius) does not have
+    auto maxZoomScale = [&]{ return (proceduralMode && !waterOnly) ? cfg::CHUNK_LOD_MAX_ZOOM : 6.0f; };
 
     
 
@@ -246,6 +253,7 @@ int main() {
     const int brushMin = 1;
     const int brushMax = 8;
     bool brushDragging = false;
+    bool strokeActive = false;         // a left/right press is editing the world; committed on release
     
     // Tools / Inventory bar (bottom-center)
     enum class Tool { Bulldozer, Brush, Eraser };
@@ -670,21 +678,10 @@ int main() {
     // Query elevation at an intersection (I,J), accounting for mode and visibility settings
     auto getIntersectionHeight = [&](int I, int J)->int {
         if (proceduralMode) {
-            auto floorDiv = [](int a, int b){ return (a >= 0) ? (a / b) : ((a - (b - 1)) / b); };
-            int cx = floorDiv(I, cfg::CHUNK_SIZE);
-            int cy = floorDiv(J, cfg::CHUNK_SIZE);
-            const Chunk& ch = chunkMgr.getChunk(cx, cy);
-            int li = I - cx * cfg::CHUNK_SIZE;
-            int lj = J - cy * cfg::CHUNK_SIZE;
-            li = std::clamp(li, 0, cfg::CHUNK_SIZE);
-            lj = std::clamp(lj, 0, cfg::CHUNK_SIZE);
-            int k = li * (cfg::CHUNK_SIZE + 1) + lj;
-            if (waterOnly) {
-                // Visible surface in water-only: override if present, else sea level (0)
-                return (k < (int)ch.overrideMask.size() && ch.overrideMask[k]) ? ch.overrides[k] : 0;
-            } else {
-                return ch.heights[k];
-            }
+            // Water-only: visible surface is the override if present, else sea level (0)
+            int h = 0;
+            chunkMgr.readRegion(I, J, I, J, waterOnly ? ChunkManager::Layer::Overrides : ChunkManager::Layer::Composited, &h, 0, 1);
+            return h;
         } else {
             int iC = std::clamp(I, 0, cfg::GRID);
             int jC = std::clamp(J, 0, cfg::GRID);
@@ -745,7 +742,7 @@ int main() {
                         sf::Vector2f defSize  = window.getDefaultView().getSize();
                         float curScale = std::max(viewSize.x / std::max(1.f, defSize.x), viewSize.y / std::max(1.f, defSize.y));
                         const float minZoom = 0.35f;  // smallest scale (most zoomed in)
-                        const float maxZoom = 6.0f;   // largest scale (most zoomed out)
+                        const float maxZoom = maxZoomScale(); // largest scale (most zoomed out)
                         float desired = (ev.mouseWheelScroll.delta > 0) ? 0.9f : 1.1f;
                         float newScale = curScale * desired;
                         float apply = desired;
@@ -906,24 +903,9 @@ int main() {
                                 int Jcenter = (int)std::floor(centerIJ.y + 0.5f);
                                 int I0 = Icenter - cfg::GRID / 2;
                                 int J0 = Jcenter - cfg::GRID / 2;
-                                auto sampleWorld = [&](int I, int J)->int{
-                                    int cx = (I >= 0) ? (I / cfg::CHUNK_SIZE) : ((I - (cfg::CHUNK_SIZE - 1)) / cfg::CHUNK_SIZE);
-                                    int cy = (J >= 0) ? (J / cfg::CHUNK_SIZE) : ((J - (cfg::CHUNK_SIZE - 1)) / cfg::CHUNK_SIZE);
-                                    int li = I - cx * cfg::CHUNK_SIZE;
-                                    int lj = J - cy * cfg::CHUNK_SIZE;
-                                    if (li < 0) { cx -= 1; li += cfg::CHUNK_SIZE; }
-                                    if (lj < 0) { cy -= 1; lj += cfg::CHUNK_SIZE; }
-                                    const Chunk& ch = chunkMgr.getChunk(cx, cy);
-                                    int S1 = cfg::CHUNK_SIZE + 1;
-                                    li = std::clamp(li, 0, cfg::CHUNK_SIZE);
-                                    lj = std::clamp(lj, 0, cfg::CHUNK_SIZE);
-                                    return ch.heights[li * S1 + lj];
-                                };
-                                for (int i = 0; i <= cfg::GRID; ++i) {
-                                    for (int j = 0; j <= cfg::GRID; ++j) {
-                                        heights[i * (cfg::GRID + 1) + j] = sampleWorld(I0 + i, J0 + j);
-                                    }
-                                }
+                                // Read through: chunks outside the view are not cached
+                                chunkMgr.readRegion(I0, J0, I0 + cfg::GRID, J0 + cfg::GRID,
+                                                    ChunkManager::Layer::Composited, heights.data());
                                 // Disable procedural mode so edits affect this baked map
                                 proceduralMode = false;
                                 chunkMgr.setMode(ChunkManager::Mode::Empty, 0);
@@ -987,74 +969,41 @@ int main() {
                             int brush = std::clamp(brushSize, brushMin, brushMax);
                             bool ctrl = sf::Keyboard::isKeyPressed(sf::Keyboard::LControl) || sf::Keyboard::isKeyPressed(sf::Keyboard::RControl);
                             if (currentTool == Tool::Bulldozer) {
+                                strokeActive = true;
                                 // Elevation edit around nearest intersection (brush)
                                 if (ctrl && (ev.mouseButton.button == sf::Mouse::Left || ev.mouseButton.button == sf::Mouse::Right)) {
                                     // Capture flatten reference height on first Ctrl+click
-                                    if (proceduralMode) {
-                                        auto floorDiv = [](int a, int b){ return (a >= 0) ? (a / b) : ((a - (b - 1)) / b); };
-                                        int cx = floorDiv(IJ.x, cfg::CHUNK_SIZE);
-                                        int cy = floorDiv(IJ.y, cfg::CHUNK_SIZE);
-                                        const Chunk& ch = chunkMgr.getChunk(cx, cy);
-                                        int li = IJ.x - cx * cfg::CHUNK_SIZE;
-                                        int lj = IJ.y - cy * cfg::CHUNK_SIZE;
-                                        li = std::clamp(li, 0, cfg::CHUNK_SIZE);
-                                        lj = std::clamp(lj, 0, cfg::CHUNK_SIZE);
-                                        int k = li * (cfg::CHUNK_SIZE + 1) + lj;
-                                        if (waterOnly) {
-                                            // Visible surface in water-only: override if present, else sea level (0)
-                                            flattenHeight = (k < (int)ch.overrideMask.size() && ch.overrideMask[k]) ? ch.overrides[k] : 0;
-                                        } else {
-                                            // Terrain visible: use actual procedural height (with overrides already applied in ch.heights)
-                                            flattenHeight = ch.heights[k];
-                                        }
-                                    } else {
-                                        flattenHeight = heights[idx(IJ.x, IJ.y)];
-                                    }
+                                    flattenHeight = getIntersectionHeight(IJ.x, IJ.y);
                                     flattenPrimed = true;
                                     // Immediately flatten current brush area (square brush)
                                     int half = brush - 1;
-                                    for (int di = -brush; di <= brush; ++di) {
-                                        for (int dj = -brush; dj <= brush; ++dj) {
-                                            int I = IJ.x + di;
-                                            int J = IJ.y + dj;
-                                            if (!proceduralMode) { if (I < 0 || J < 0 || I > cfg::GRID || J > cfg::GRID) continue; }
-                                            if (std::max(std::abs(di), std::abs(dj)) > half) continue;
-                                            if (proceduralMode) {
-                                                chunkMgr.applySetAt(I, J, flattenHeight);
-                                            } else {
+                                    if (proceduralMode) {
+                                        chunkMgr.editRegion(IJ.x - half, IJ.y - half, IJ.x + half, IJ.y + half,
+                                                            ChunkManager::EditOp::Set, flattenHeight);
+                                    } else {
+                                        for (int di = -half; di <= half; ++di) {
+                                            for (int dj = -half; dj <= half; ++dj) {
+                                                int I = IJ.x + di;
+                                                int J = IJ.y + dj;
+                                                if (I < 0 || J < 0 || I > cfg::GRID || J > cfg::GRID) continue;
                                                 heights[idx(I, J)] = flattenHeight;
                                             }
                                         }
                                     }
                                 } else {
                                     int delta = (ev.mouseButton.button == sf::Mouse::Left) ? 1 : -1;
+                                    // square brush shape (Chebyshev radius)
                                     int half = brush - 1;
-                                    for (int di = -brush; di <= brush; ++di) {
-                                        for (int dj = -brush; dj <= brush; ++dj) {
-                                            int I = IJ.x + di;
-                                            int J = IJ.y + dj;
-                                            if (!proceduralMode) { if (I < 0 || J < 0 || I > cfg::GRID || J > cfg::GRID) continue; }
-                                            // square brush shape (Chebyshev radius)
-                                            if (std::max(std::abs(di), std::abs(dj)) > (brush - 1)) continue;
-                                            if (proceduralMode) {
-                                                if (waterOnly) {
-                                                    // Start from sea (0) unless an override exists
-                                                    auto floorDiv = [](int a, int b){ return (a >= 0) ? (a / b) : ((a - (b - 1)) / b); };
-                                                    int cx = floorDiv(I, cfg::CHUNK_SIZE);
-                                                    int cy = floorDiv(J, cfg::CHUNK_SIZE);
-                                                    const Chunk& ch = chunkMgr.getChunk(cx, cy);
-                                                    int li = I - cx * cfg::CHUNK_SIZE;
-                                                    int lj = J - cy * cfg::CHUNK_SIZE;
-                                                    li = std::clamp(li, 0, cfg::CHUNK_SIZE);
-                                                    lj = std::clamp(lj, 0, cfg::CHUNK_SIZE);
-                                                    int k = li * (cfg::CHUNK_SIZE + 1) + lj;
-                                                    int base = (k < (int)ch.overrideMask.size() && ch.overrideMask[k]) ? ch.overrides[k] : 0;
-                                                    int v = std::clamp(base + delta, cfg::MIN_ELEV, cfg::MAX_ELEV);
-                                                    chunkMgr.applySetAt(I, J, v);
-                                                } else {
-                                                    chunkMgr.applyDeltaAt(I, J, delta);
-                                                }
-                                            } else {
+                                    if (proceduralMode) {
+                                        // Water-only: start from sea (0) unless an override exists
+                                        chunkMgr.editRegion(IJ.x - half, IJ.y - half, IJ.x + half, IJ.y + half,
+                                                            waterOnly ? ChunkManager::EditOp::AddToEdits : ChunkManager::EditOp::Add, delta);
+                                    } else {
+                                        for (int di = -half; di <= half; ++di) {
+                                            for (int dj = -half; dj <= half; ++dj) {
+                                                int I = IJ.x + di;
+                                                int J = IJ.y + dj;
+                                                if (I < 0 || J < 0 || I > cfg::GRID || J > cfg::GRID) continue;
                                                 heights[idx(I, J)] += delta;
                                             }
                                         }
@@ -1088,6 +1037,10 @@ int main() {
                     if (ev.mouseButton.button == sf::Mouse::Left || ev.mouseButton.button == sf::Mouse::Right) tilting = false;
                     if (ev.mouseButton.button == sf::Mouse::Left) toneDragging = false;
                     brushDragging = false;
+                    if ((ev.mouseButton.button == sf::Mouse::Left || ev.mouseButton.button == sf::Mouse::Right) && strokeActive) {
+                        chunkMgr.commitEdits(); // one journal record per stroke
+                        strokeActive = false;
+                    }
                     break;
                 case sf::Event::MouseMoved:
                     {
@@ -1132,18 +1085,19 @@ int main() {
                                     sf::Vector2i IJ = worldToGridIntersection(world);
                                     int brush = std::clamp(brushSize, brushMin, brushMax);
                                     bool ctrl = sf::Keyboard::isKeyPressed(sf::Keyboard::LControl) || sf::Keyboard::isKeyPressed(sf::Keyboard::RControl);
+                                    if (currentTool == Tool::Bulldozer) strokeActive = true; // a drag may enter the grid
                                     if (currentTool == Tool::Bulldozer && ctrl && flattenPrimed && (sf::Mouse::isButtonPressed(sf::Mouse::Left) || sf::Mouse::isButtonPressed(sf::Mouse::Right))) {
                                         // Flatten to captured height while Ctrl is held
                                         int half = brush - 1;
-                                        for (int di = -brush; di <= brush; ++di) {
-                                            for (int dj = -brush; dj <= brush; ++dj) {
-                                                int I = IJ.x + di;
-                                                int J = IJ.y + dj;
-                                                if (!proceduralMode) { if (I < 0 || J < 0 || I > cfg::GRID || J > cfg::GRID) continue; }
-                                                if (std::max(std::abs(di), std::abs(dj)) > half) continue;
-                                                if (proceduralMode) {
-                                                    chunkMgr.applySetAt(I, J, flattenHeight);
-                                                } else {
+                                        if (proceduralMode) {
+                                            chunkMgr.editRegion(IJ.x - half, IJ.y - half, IJ.x + half, IJ.y + half,
+                                                                ChunkManager::EditOp::Set, flattenHeight);
+                                        } else {
+                                            for (int di = -half; di <= half; ++di) {
+                                                for (int dj = -half; dj <= half; ++dj) {
+                                                    int I = IJ.x + di;
+                                                    int J = IJ.y + dj;
+                                                    if (I < 0 || J < 0 || I > cfg::GRID || J > cfg::GRID) continue;
                                                     heights[idx(I, J)] = flattenHeight;
                                                 }
                                             }
@@ -1151,31 +1105,16 @@ int main() {
                                     } else if (currentTool == Tool::Bulldozer) {
                                         int delta = sf::Mouse::isButtonPressed(sf::Mouse::Left) ? 1 : -1;
                                         int half = brush - 1;
-                                        for (int di = -brush; di <= brush; ++di) {
-                                            for (int dj = -brush; dj <= brush; ++dj) {
-                                                int I = IJ.x + di;
-                                                int J = IJ.y + dj;
-                                                if (!proceduralMode) { if (I < 0 || J < 0 || I > cfg::GRID || J > cfg::GRID) continue; }
-                                                if (std::max(std::abs(di), std::abs(dj)) > half) continue;
-                                                if (proceduralMode) {
-                                                    if (waterOnly) {
-                                                        // Start from sea (0) unless an override exists
-                                                        auto floorDiv = [](int a, int b){ return (a >= 0) ? (a / b) : ((a - (b - 1)) / b); };
-                                                        int cx = floorDiv(I, cfg::CHUNK_SIZE);
-                                                        int cy = floorDiv(J, cfg::CHUNK_SIZE);
-                                                        const Chunk& ch = chunkMgr.getChunk(cx, cy);
-                                                        int li = I - cx * cfg::CHUNK_SIZE;
-                                                        int lj = J - cy * cfg::CHUNK_SIZE;
-                                                        li = std::clamp(li, 0, cfg::CHUNK_SIZE);
-                                                        lj = std::clamp(lj, 0, cfg::CHUNK_SIZE);
-                                                        int k = li * (cfg::CHUNK_SIZE + 1) + lj;
-                                                        int base = (k < (int)ch.overrideMask.size() && ch.overrideMask[k]) ? ch.overrides[k] : 0;
-                                                        int v = std::clamp(base + delta, cfg::MIN_ELEV, cfg::MAX_ELEV);
-                                                        chunkMgr.applySetAt(I, J, v);
-                                                    } else {
-                                                        chunkMgr.applyDeltaAt(I, J, delta);
-                                                    }
-                                                } else {
+                                        if (proceduralMode) {
+                                            // Water-only: start from sea (0) unless an override exists
+                                            chunkMgr.editRegion(IJ.x - half, IJ.y - half, IJ.x + half, IJ.y + half,
+                                                                waterOnly ? ChunkManager::EditOp::AddToEdits : ChunkManager::EditOp::Add, delta);
+                                        } else {
+                                            for (int di = -half; di <= half; ++di) {
+                                                for (int dj = -half; dj <= half; ++dj) {
+                                                    int I = IJ.x + di;
+                                                    int J = IJ.y + dj;
+                                                    if (I < 0 || J < 0 || I > cfg::GRID || J > cfg::GRID) continue;
                                                     heights[idx(I, J)] += delta;
                                                 }
                                             }
@@ -1300,6 +1239,12 @@ int main() {
         sf::Vector2f viewSize = view.getSize();
         sf::Vector2f defSize  = window.getDefaultView().getSize();
         float zoomScale = std::max(viewSize.x / std::max(1.f, defSize.x), viewSize.y / std::max(1.f, defSize.y));
+        // Back within the limit after leaving the coarse-level views (reset to water-only, flat map)
+        if (zoomScale > maxZoomScale()) {
+            view.zoom(maxZoomScale() / zoomScale);
+            window.setView(view);
+            zoomScale = maxZoomScale();
+        }
         float panSpeed = panSpeedBase * std::max(0.1f, zoomScale);
         // Real delta time to keep speed consistent across refresh rates/fullscreen
         float dt = frameClock.restart().asSeconds();
@@ -1390,6 +1335,16 @@ int main() {
             const int hardMaxRadius = 10;   // never generate beyond this many chunks from center
             const float lodBase = 7.5f;     // tune base radius
             int allowedRadius = (int)std::clamp(std::round(lodBase / std::max(0.5f, zoomScale)), 2.f, (float)hardMaxRadius);
+            // Resolution level: the coarsest whose quads stay under CHUNK_LOD_QUAD_PX on screen.
+            // Coarse levels cost a fraction of a full chunk, so they are drawn much farther out.
+            // Water-only shows the edits layer, which has no coarse levels.
+            int level = 0;
+            if (!waterOnly) {
+                const float tilePx = cfg::TILE_W / std::max(0.01f, zoomScale);
+                while (level + 1 < cfg::CHUNK_LOD_LEVELS &&
+                       ChunkManager::levelStride(level + 1) * tilePx <= cfg::CHUNK_LOD_QUAD_PX) ++level;
+            }
+            const int drawRadius = level > 0 ? cfg::CHUNK_LOD_MAX_RADIUS : allowedRadius;
 
             // Determine center chunk from view center in grid coords
             sf::Vector2f ijC = unproj(vc);
@@ -1398,39 +1353,90 @@ int main() {
             int ccx = floorDiv(Icenter, cfg::CHUNK_SIZE);
             int ccy = floorDiv(Jcenter, cfg::CHUNK_SIZE);
 
+            // Background generation: nearest chunks first, drop requests the camera left behind
+            chunkMgr.setViewFocus(ccx, ccy, allowedRadius);
+            chunkMgr.pumpCompleted();
+
+            // Prefetch: extrapolate pan/zoom over the horizon and warm chunks about to appear
+            prefetcher.observe(ijC.x, ijC.y, zoomScale, dt);
+            ChunkPrefetcher::Prediction pred = prefetcher.predict();
+            if (pred.moving) {
+                ChunkWindow cur{cx0, cx1, cy0, cy1, ccx, ccy, allowedRadius};
+                float pI = ijC.x + pred.dI;
+                float pJ = ijC.y + pred.dJ;
+                float zf = pred.zoomFactor;
+                int aI0 = (int)std::floor(pI + (minI - ijC.x) * zf);
+                int aI1 = (int)std::ceil (pI + (maxI - ijC.x) * zf);
+                int aJ0 = (int)std::floor(pJ + (minJ - ijC.y) * zf);
+                int aJ1 = (int)std::ceil (pJ + (maxJ - ijC.y) * zf);
+                ChunkWindow ahead;
+                ahead.cx0 = floorDiv(aI0, cfg::CHUNK_SIZE);
+                ahead.cx1 = floorDiv(aI1, cfg::CHUNK_SIZE);
+                ahead.cy0 = floorDiv(aJ0, cfg::CHUNK_SIZE);
+                ahead.cy1 = floorDiv(aJ1, cfg::CHUNK_SIZE);
+                ahead.ccx = floorDiv((int)std::floor(pI + 0.5f), cfg::CHUNK_SIZE);
+                ahead.ccy = floorDiv((int)std::floor(pJ + 0.5f), cfg::CHUNK_SIZE);
+                ahead.radius = (int)std::clamp(std::round(lodBase / std::max(0.5f, zoomScale * zf)), 2.f, (float)hardMaxRadius);
+                ChunkPrefetcher::collect(cur, ahead, (size_t)chunkMgr.prefetchBudget(), prefetchKeys);
+            } else {
+                prefetchKeys.clear();
+            }
+            if (waterOnly || level > 0) prefetchKeys.clear(); // nothing worth generating ahead at full resolution
+            chunkMgr.prefetch(prefetchKeys);
+
+            // Coarse level: build the visible chunks missing from it, nearest first
+            if (level > 0) {
+                levelKeys.clear();
+                for (int cx = cx0; cx <= cx1; ++cx)
+                    for (int cy = cy0; cy <= cy1; ++cy)
+                        if (std::max(std::abs(cx - ccx), std::abs(cy - ccy)) <= drawRadius) levelKeys.push_back(ChunkKey{cx, cy});
+                std::sort(levelKeys.begin(), levelKeys.end(), [&](const ChunkKey& a, const ChunkKey& b){
+                    return std::max(std::abs(a.cx - ccx), std::abs(a.cy - ccy)) < std::max(std::abs(b.cx - ccx), std::abs(b.cy - ccy));
+                });
+                chunkMgr.buildLevel(levelKeys, level, cfg::CHUNK_LOD_BUILD_MAX);
+            }
+
+            framePins.clear();
             for (int cx = cx0; cx <= cx1; ++cx) {
                 for (int cy = cy0; cy <= cy1; ++cy) {
                     // Skip chunks outside LOD radius (Chebyshev distance for square ring)
                     int dx = std::abs(cx - ccx);
                     int dy = std::abs(cy - ccy);
-                    if (std::max(dx, dy) > allowedRadius) continue;
-                    const Chunk& ch = chunkMgr.getChunk(cx, cy);
+                    if (std::max(dx, dy) > drawRadius) continue;
                     int I0 = cx * cfg::CHUNK_SIZE;
                     int J0 = cy * cfg::CHUNK_SIZE;
-                    // If water-only: base is flat sea (0). Show only user edits (overrides) above sea.
-                    if (waterOnly) {
-                        static std::vector<int> waterBuf;
-                        const int side1 = (cfg::CHUNK_SIZE + 1);
-                        waterBuf.resize(side1 * side1);
-                        for (size_t k = 0; k < waterBuf.size(); ++k) {
-                            int v = 0;
-                            // Only show explicit edits; ignore generated terrain
-                            if (k < ch.overrideMask.size() && ch.overrideMask[k]) v = ch.overrides[k];
-                            // Keep full range so digging (<0) is visible as deeper water
-                            waterBuf[k] = std::clamp(v, cfg::MIN_ELEV, cfg::MAX_ELEV);
-                        }
-                        auto cMap2d = render::buildProjectedMapChunk(waterBuf, cfg::CHUNK_SIZE, I0, J0, iso, origin, 1.0f);
-                        render::draw2DFilledCellsChunk(window, cMap2d, waterBuf, cfg::CHUNK_SIZE, shadowsEnabled, 1.0f, I0, J0, &paintedCells,
-                                                       (showColorHover && currentTool == Tool::Brush) ? &hoverMask : nullptr,
-                                                       (showColorHover && currentTool == Tool::Brush) ? &activeColor : nullptr);
-                        if (showGrid) render::draw2DMapChunk(window, cMap2d);
-                    } else {
-                        auto cMap2d = render::buildProjectedMapChunk(ch.heights, cfg::CHUNK_SIZE, I0, J0, iso, origin, 1.0f);
-                        render::draw2DFilledCellsChunk(window, cMap2d, ch.heights, cfg::CHUNK_SIZE, shadowsEnabled, 1.0f, I0, J0, &paintedCells,
-                                                       (showColorHover && currentTool == Tool::Brush) ? &hoverMask : nullptr,
-                                                       (showColorHover && currentTool == Tool::Brush) ? &activeColor : nullptr);
-                        if (showGrid) render::draw2DMapChunk(window, cMap2d);
+                    // Full chunk when the level asks for it; water-only draws the edits over sea
+                    // level, so no terrain is generated for it
+                    ChunkManager::Pin pin;
+                    if (level == 0) pin = chunkMgr.tryPin(cx, cy, waterOnly ? ChunkManager::Layer::Overrides
+                                                                            : ChunkManager::Layer::Composited);
+                    const int16_t* tile = pin ? (waterOnly ? pin->waterData() : pin->heightData()) : nullptr;
+                    int drawn = 0;
+                    // No full chunk (coarse view or still generating): the wanted level, else any
+                    // nearest one already built, finest first (zooming in shows it until the full
+                    // chunk arrives)
+                    if (!tile && !waterOnly) {
+                        if (level > 0 && (tile = chunkMgr.levelHeights(cx, cy, level))) drawn = level;
+                        for (int l = 1; l < cfg::CHUNK_LOD_LEVELS && !tile; ++l)
+                            if ((tile = chunkMgr.levelHeights(cx, cy, l))) drawn = l;
+                        // Else its low-octave preview, published before the full detail
+                        if (!tile && level == 0) tile = chunkMgr.previewHeights(cx, cy);
                     }
+                    // Nothing yet: draw a cheap flat-sea placeholder (no shadows needed)
+                    const bool placeholder = !tile;
+                    if (placeholder) tile = ChunkPool::uniform(0);
+                    const int S = ChunkManager::levelSide(drawn) - 1;
+                    const int step = ChunkManager::levelStride(drawn);
+                    auto cMap2d = render::buildProjectedMapChunk(tile, S, I0, J0, iso, origin, 1.0f, step);
+                    // Shadows continue into the neighbours' heights through the chunk's halo
+                    const int16_t* halo = (pin && shadowsEnabled && !waterOnly) ? chunkMgr.halo(pin) : nullptr;
+                    const bool shade = shadowsEnabled && !placeholder;
+                    render::draw2DFilledCellsChunk(window, cMap2d, tile, halo, S, shade, 1.0f, I0, J0, &paintedCells,
+                                                   (showColorHover && currentTool == Tool::Brush) ? &hoverMask : nullptr,
+                                                   (showColorHover && currentTool == Tool::Brush) ? &activeColor : nullptr,
+                                                   step);
+                    if (showGrid) render::draw2DMapChunk(window, cMap2d);
+                    if (pin) framePins.push_back(std::move(pin));
                 }
             }
         } else {
@@ -0,0 +1,94 @@
+#include "mmapfile.hpp"
+#include <utility>
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX 1
+#endif
+#include <windows.h>
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile& MappedFile::operator=(MappedFile&& o) noexcept {
+    if (this != &o) {
+        close();
+        std::swap(_data, o._data);
+        std::swap(_size, o._size);
+#ifdef _WIN32
+        std::swap(_file, o._file);
+        std::swap(_mapping, o._mapping);
+#endif
+    }
+    return *this;
+}
+
+#ifdef _WIN32
+bool MappedFile::open(const std::string& path) {
+    close();
+    HANDLE f = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                           nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (f == INVALID_HANDLE_VALUE) return false;
+    LARGE_INTEGER sz;
+    if (!GetFileSizeEx(f, &sz) || sz.QuadPart == 0) { CloseHandle(f); return false; }
+    HANDLE m = CreateFileMappingA(f, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!m) { CloseHandle(f); return false; }
+    void* p = MapViewOfFile(m, FILE_MAP_READ, 0, 0, 0);
+    if (!p) { CloseHandle(m); CloseHandle(f); return false; }
+    _file = f; _mapping = m;
+    _data = static_cast<const uint8_t*>(p);
+    _size = static_cast<size_t>(sz.QuadPart);
+    return true;
+}
+
+void MappedFile::close() {
+    if (_data) UnmapViewOfFile(_data);
+    if (_mapping) CloseHandle((HANDLE)_mapping);
+    if (_file) CloseHandle((HANDLE)_file);
+    _data = nullptr; _size = 0; _mapping = nullptr; _file = nullptr;
+}
+
+bool syncFile(const std::string& path) {
+    HANDLE f = CreateFileA(path.c_str(), GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                           nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (f == INVALID_HANDLE_VALUE) return false;
+    bool ok = FlushFileBuffers(f) != 0;
+    CloseHandle(f);
+    return ok;
+}
+
+bool syncFile(std::FILE* f) { return _commit(_fileno(f)) == 0; }
+#else
+bool MappedFile::open(const std::string& path) {
+    close();
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) { ::close(fd); return false; }
+    void* p = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd); // the mapping stays valid after closing the descriptor
+    if (p == MAP_FAILED) return false;
+    _data = static_cast<const uint8_t*>(p);
+    _size = (size_t)st.st_size;
+    return true;
+}
+
+void MappedFile::close() {
+    if (_data) munmap(const_cast<uint8_t*>(_data), _size);
+    _data = nullptr; _size = 0;
+}
+
+bool syncFile(const std::string& path) {
+    // fsync applies to the file, not the descriptor: a fresh one sees the stream's writes
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    bool ok = fsync(fd) == 0;
+    ::close(fd);
+    return ok;
+}
+
+bool syncFile(std::FILE* f) { return fsync(fileno(f)) == 0; }
+#endif
@@ -0,0 +1,39 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+// Read-only memory mapping of a whole file (POSIX mmap / Win32 file mapping).
+// An empty or missing file yields an invalid mapping (data() == nullptr).
+class MappedFile {
+public:
+    MappedFile() = default;
+    explicit MappedFile(const std::string& path) { open(path); }
+    ~MappedFile() { close(); }
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& o) noexcept { *this = std::move(o); }
+    MappedFile& operator=(MappedFile&& o) noexcept;
+
+    bool open(const std::string& path);
+    void close();
+
+    const uint8_t* data() const { return _data; }
+    size_t size() const { return _size; }
+    bool valid() const { return _data != nullptr; }
+
+private:
+    const uint8_t* _data = nullptr;
+    size_t _size = 0;
+#ifdef _WIN32
+    void* _file = nullptr;
+    void* _mapping = nullptr;
+#endif
+};
+
+// Forces data already written to a file (and flushed out of user-space buffers) onto the storage
+// device (fsync / FlushFileBuffers), so it survives an OS crash or power loss, not only a
+// process crash. False when the file cannot be opened or the device reports an error.
+bool syncFile(const std::string& path);
+bool syncFile(std::FILE* f);
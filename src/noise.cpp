@@ -1,6 +1,13 @@
 #include "noise.hpp"
+#include <algorithm>
 #include <cmath>
 #include <cstdint>
+#include <vector>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define NOISE_X86 1
+#include <immintrin.h>
+#endif
 
 namespace {
     // 32-bit integer hash (xorshift-like) for deterministic value noise
@@ -34,6 +41,152 @@ namespace {
         float vx1 = lerp(v01, v11, u);
         return lerp(vx0, vx1, v);
     }
+
+    using RowFn = void (*)(const float* xs, const float* ys, int n, float* out,
+                           uint32_t seed, int octaves, float lacunarity, float gain);
+
+    void fbmRowScalar(const float* xs, const float* ys, int n, float* out,
+                      uint32_t seed, int octaves, float lacunarity, float gain) {
+        for (int t = 0; t < n; ++t) out[t] = noise::fbm(xs[t], ys[t], seed, octaves, lacunarity, gain);
+    }
+
+#if NOISE_X86
+    // Vector kernels: the scalar operations lane by lane, in the same order and without
+    // contraction into FMA, so every sample matches fbm() bit for bit.
+    // Tails shorter than a vector are padded through a local buffer.
+#define NOISE_AVX2 __attribute__((target("avx2")))
+#define NOISE_SSE41 __attribute__((target("sse4.1")))
+
+    NOISE_AVX2 inline __m256i hash8(__m256i x, __m256i y, uint32_t seed) {
+        __m256i h = _mm256_xor_si256(_mm256_mullo_epi32(x, _mm256_set1_epi32((int)0x27d4eb2dU)),
+                                     _mm256_mullo_epi32(y, _mm256_set1_epi32((int)0x165667b1U)));
+        h = _mm256_xor_si256(h, _mm256_set1_epi32((int)(seed * 0x9e3779b9U)));
+        h = _mm256_xor_si256(h, _mm256_srli_epi32(h, 15));
+        h = _mm256_mullo_epi32(h, _mm256_set1_epi32((int)0x85ebca6bU));
+        h = _mm256_xor_si256(h, _mm256_srli_epi32(h, 13));
+        h = _mm256_mullo_epi32(h, _mm256_set1_epi32((int)0xc2b2ae35U));
+        return _mm256_xor_si256(h, _mm256_srli_epi32(h, 16));
+    }
+    NOISE_AVX2 inline __m256 val8(__m256i h) {
+        // (h & 0xFFFFFF) / 2^24: exact either way, as a product
+        return _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_and_si256(h, _mm256_set1_epi32(0xFFFFFF))),
+                             _mm256_set1_ps(1.0f / 16777216.0f));
+    }
+    NOISE_AVX2 inline __m256 smooth8(__m256 t) {
+        return _mm256_mul_ps(_mm256_mul_ps(t, t), _mm256_sub_ps(_mm256_set1_ps(3.f), _mm256_mul_ps(_mm256_set1_ps(2.f), t)));
+    }
+    NOISE_AVX2 inline __m256 lerp8(__m256 a, __m256 b, __m256 t) {
+        return _mm256_add_ps(a, _mm256_mul_ps(_mm256_sub_ps(b, a), t));
+    }
+    NOISE_AVX2 inline __m256 valueNoise8(__m256 x, __m256 y, uint32_t seed) {
+        const __m256 xfl = _mm256_floor_ps(x), yfl = _mm256_floor_ps(y);
+        const __m256i xi = _mm256_cvttps_epi32(xfl), yi = _mm256_cvttps_epi32(yfl);
+        const __m256 u = smooth8(_mm256_sub_ps(x, _mm256_cvtepi32_ps(xi)));
+        const __m256 v = smooth8(_mm256_sub_ps(y, _mm256_cvtepi32_ps(yi)));
+        const __m256i one = _mm256_set1_epi32(1);
+        const __m256i xi1 = _mm256_add_epi32(xi, one), yi1 = _mm256_add_epi32(yi, one);
+        const __m256 vx0 = lerp8(val8(hash8(xi, yi, seed)), val8(hash8(xi1, yi, seed)), u);
+        const __m256 vx1 = lerp8(val8(hash8(xi, yi1, seed)), val8(hash8(xi1, yi1, seed)), u);
+        return lerp8(vx0, vx1, v);
+    }
+    NOISE_AVX2 inline __m256 fbm8(__m256 x, __m256 y, uint32_t seed, int octaves, float lacunarity, float gain) {
+        float amp = 0.5f, freq = 1.0f, norm = 0.0f;
+        __m256 sum = _mm256_setzero_ps();
+        for (int o = 0; o < octaves; ++o) {
+            const __m256 f = _mm256_set1_ps(freq);
+            const __m256 n = valueNoise8(_mm256_mul_ps(x, f), _mm256_mul_ps(y, f), seed + static_cast<uint32_t>(o * 1315423911U));
+            const __m256 s = _mm256_sub_ps(_mm256_mul_ps(n, _mm256_set1_ps(2.f)), _mm256_set1_ps(1.f));
+            sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_set1_ps(amp), s));
+            norm += amp;
+            freq *= lacunarity;
+            amp *= gain;
+        }
+        if (norm > 0.f) sum = _mm256_div_ps(sum, _mm256_set1_ps(norm));
+        return _mm256_min_ps(_mm256_max_ps(sum, _mm256_set1_ps(-1.f)), _mm256_set1_ps(1.f));
+    }
+    NOISE_AVX2 void fbmRowAvx2(const float* xs, const float* ys, int n, float* out,
+                               uint32_t seed, int octaves, float lacunarity, float gain) {
+        int t = 0;
+        for (; t + 8 <= n; t += 8)
+            _mm256_storeu_ps(out + t, fbm8(_mm256_loadu_ps(xs + t), _mm256_loadu_ps(ys + t), seed, octaves, lacunarity, gain));
+        if (t == n) return;
+        float bx[8] = {}, by[8] = {}, bo[8];
+        for (int u = 0; t + u < n; ++u) { bx[u] = xs[t + u]; by[u] = ys[t + u]; }
+        _mm256_storeu_ps(bo, fbm8(_mm256_loadu_ps(bx), _mm256_loadu_ps(by), seed, octaves, lacunarity, gain));
+        for (int u = 0; t + u < n; ++u) out[t + u] = bo[u];
+    }
+
+    NOISE_SSE41 inline __m128i hash4(__m128i x, __m128i y, uint32_t seed) {
+        __m128i h = _mm_xor_si128(_mm_mullo_epi32(x, _mm_set1_epi32((int)0x27d4eb2dU)),
+                                  _mm_mullo_epi32(y, _mm_set1_epi32((int)0x165667b1U)));
+        h = _mm_xor_si128(h, _mm_set1_epi32((int)(seed * 0x9e3779b9U)));
+        h = _mm_xor_si128(h, _mm_srli_epi32(h, 15));
+        h = _mm_mullo_epi32(h, _mm_set1_epi32((int)0x85ebca6bU));
+        h = _mm_xor_si128(h, _mm_srli_epi32(h, 13));
+        h = _mm_mullo_epi32(h, _mm_set1_epi32((int)0xc2b2ae35U));
+        return _mm_xor_si128(h, _mm_srli_epi32(h, 16));
+    }
+    NOISE_SSE41 inline __m128 val4(__m128i h) {
+        return _mm_mul_ps(_mm_cvtepi32_ps(_mm_and_si128(h, _mm_set1_epi32(0xFFFFFF))), _mm_set1_ps(1.0f / 16777216.0f));
+    }
+    NOISE_SSE41 inline __m128 smooth4(__m128 t) {
+        return _mm_mul_ps(_mm_mul_ps(t, t), _mm_sub_ps(_mm_set1_ps(3.f), _mm_mul_ps(_mm_set1_ps(2.f), t)));
+    }
+    NOISE_SSE41 inline __m128 lerp4(__m128 a, __m128 b, __m128 t) {
+        return _mm_add_ps(a, _mm_mul_ps(_mm_sub_ps(b, a), t));
+    }
+    NOISE_SSE41 inline __m128 valueNoise4(__m128 x, __m128 y, uint32_t seed) {
+        const __m128i xi = _mm_cvttps_epi32(_mm_floor_ps(x)), yi = _mm_cvttps_epi32(_mm_floor_ps(y));
+        const __m128 u = smooth4(_mm_sub_ps(x, _mm_cvtepi32_ps(xi)));
+        const __m128 v = smooth4(_mm_sub_ps(y, _mm_cvtepi32_ps(yi)));
+        const __m128i one = _mm_set1_epi32(1);
+        const __m128i xi1 = _mm_add_epi32(xi, one), yi1 = _mm_add_epi32(yi, one);
+        const __m128 vx0 = lerp4(val4(hash4(xi, yi, seed)), val4(hash4(xi1, yi, seed)), u);
+        const __m128 vx1 = lerp4(val4(hash4(xi, yi1, seed)), val4(hash4(xi1, yi1, seed)), u);
+        return lerp4(vx0, vx1, v);
+    }
+    NOISE_SSE41 inline __m128 fbm4(__m128 x, __m128 y, uint32_t seed, int octaves, float lacunarity, float gain) {
+        float amp = 0.5f, freq = 1.0f, norm = 0.0f;
+        __m128 sum = _mm_setzero_ps();
+        for (int o = 0; o < octaves; ++o) {
+            const __m128 f = _mm_set1_ps(freq);
+            const __m128 n = valueNoise4(_mm_mul_ps(x, f), _mm_mul_ps(y, f), seed + static_cast<uint32_t>(o * 1315423911U));
+            const __m128 s = _mm_sub_ps(_mm_mul_ps(n, _mm_set1_ps(2.f)), _mm_set1_ps(1.f));
+            sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(amp), s));
+            norm += amp;
+            freq *= lacunarity;
+            amp *= gain;
+        }
+        if (norm > 0.f) sum = _mm_div_ps(sum, _mm_set1_ps(norm));
+        return _mm_min_ps(_mm_max_ps(sum, _mm_set1_ps(-1.f)), _mm_set1_ps(1.f));
+    }
+    NOISE_SSE41 void fbmRowSse41(const float* xs, const float* ys, int n, float* out,
+                                 uint32_t seed, int octaves, float lacunarity, float gain) {
+        int t = 0;
+        for (; t + 4 <= n; t += 4)
+            _mm_storeu_ps(out + t, fbm4(_mm_loadu_ps(xs + t), _mm_loadu_ps(ys + t), seed, octaves, lacunarity, gain));
+        if (t == n) return;
+        float bx[4] = {}, by[4] = {}, bo[4];
+        for (int u = 0; t + u < n; ++u) { bx[u] = xs[t + u]; by[u] = ys[t + u]; }
+        _mm_storeu_ps(bo, fbm4(_mm_loadu_ps(bx), _mm_loadu_ps(by), seed, octaves, lacunarity, gain));
+        for (int u = 0; t + u < n; ++u) out[t + u] = bo[u];
+    }
+
+#endif
+
+    struct Path { RowFn fn; const char* name; };
+    Path pickPath() {
+#if NOISE_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) return Path{fbmRowAvx2, "avx2"};
+        if (__builtin_cpu_supports("sse4.1")) return Path{fbmRowSse41, "sse4.1"};
+#endif
+        return Path{fbmRowScalar, "scalar"};
+    }
+    const Path& path() {
+        static const Path p = pickPath();
+        return p;
+    }
 }
 
 namespace noise {
@@ -55,4 +208,113 @@ float fbm(float x, float y, uint32_t seed, int octaves, float lacunarity, float
     return sum;
 }
 
+void fbmRow(const float* xs, const float* ys, int n, float* out,
+            uint32_t seed, int octaves, float lacunarity, float gain) {
+    path().fn(xs, ys, n, out, seed, octaves, lacunarity, gain);
+}
+
+void fbmGrid(const float* xs, int rows, const float* ys, int cols, float* out,
+             uint32_t seed, int octaves, float lacunarity, float gain) {
+    const size_t count = (size_t)rows * cols;
+    if (count == 0) return;
+    std::fill(out, out + count, 0.0f);
+    fbmGridOctaves(xs, rows, ys, cols, out, seed, 0, octaves, lacunarity, gain);
+    fbmFinish(out, (int)count, octaves, gain);
+}
+
+void fbmGridOctaves(const float* xs, int rows, const float* ys, int cols, float* out,
+                    uint32_t seed, int first, int last, float lacunarity, float gain) {
+    const size_t count = (size_t)rows * cols;
+    if (count == 0) return;
+    thread_local std::vector<int> yi;
+    thread_local std::vector<float> yv, lattice, rowv;
+    yi.resize((size_t)cols);
+    yv.resize((size_t)cols);
+    // Octave first's amplitude and frequency, stepped as a single pass would
+    float amp = 0.5f;
+    float freq = 1.0f;
+    for (int o = 0; o < first; ++o) {
+        freq *= lacunarity;
+        amp *= gain;
+    }
+    for (int o = first; o < last; ++o) {
+        const uint32_t oseed = seed + static_cast<uint32_t>(o * 1315423911U);
+        // Column terms: lattice cell and smoothstep weight, shared by every row
+        int ylo = 0, yhi = 0;
+        for (int c = 0; c < cols; ++c) {
+            const float fy = ys[c] * freq;
+            const int y0 = static_cast<int>(std::floor(fy));
+            yi[(size_t)c] = y0;
+            yv[(size_t)c] = smoothstep(fy - static_cast<float>(y0));
+            if (c == 0 || y0 < ylo) ylo = y0;
+            if (c == 0 || y0 > yhi) yhi = y0;
+        }
+        int xlo = 0, xhi = 0;
+        for (int r = 0; r < rows; ++r) {
+            const int x0 = static_cast<int>(std::floor(xs[r] * freq));
+            if (r == 0 || x0 < xlo) xlo = x0;
+            if (r == 0 || x0 > xhi) xhi = x0;
+        }
+        const int lw = yhi - ylo + 2; // lattice columns ylo..yhi+1
+        const size_t cells = (size_t)(xhi - xlo + 2) * (size_t)lw;
+        if (cells > count) {
+            // Finer lattice than the samples (a tiny block at a high octave): nothing to share
+            for (int r = 0; r < rows; ++r)
+                for (int c = 0; c < cols; ++c)
+                    out[(size_t)r * cols + c] += amp * (valueNoise2D(xs[r] * freq, ys[c] * freq, oseed) * 2.f - 1.f);
+        } else {
+            // Hash the lattice patch covering the block once
+            lattice.resize(cells);
+            for (int lx = xlo; lx <= xhi + 1; ++lx)
+                for (int ly = ylo; ly <= yhi + 1; ++ly)
+                    lattice[(size_t)(lx - xlo) * lw + (ly - ylo)] = valFromHash(hash2d(lx, ly, oseed));
+            rowv.resize((size_t)lw);
+            for (int r = 0; r < rows; ++r) {
+                const float fx = xs[r] * freq;
+                const int x0 = static_cast<int>(std::floor(fx));
+                const float u = smoothstep(fx - static_cast<float>(x0));
+                // Lerp along x once per lattice column, then along y per sample: the same
+                // operations valueNoise2D does per sample, so the result is identical
+                const float* l0 = &lattice[(size_t)(x0 - xlo) * lw];
+                const float* l1 = l0 + lw;
+                for (int k = 0; k < lw; ++k) rowv[(size_t)k] = lerp(l0[k], l1[k], u);
+                float* row = out + (size_t)r * cols;
+                for (int c = 0; c < cols; ++c) {
+                    const size_t k = (size_t)(yi[(size_t)c] - ylo);
+                    row[c] += amp * (lerp(rowv[k], rowv[k + 1], yv[(size_t)c]) * 2.f - 1.f);
+                }
+            }
+        }
+        freq *= lacunarity;
+        amp *= gain;
+    }
+}
+
+void fbmFinish(float* out, int count, int octaves, float gain) {
+    float amp = 0.5f;
+    float norm = 0.0f;
+    for (int o = 0; o < octaves; ++o) {
+        norm += amp;
+        amp *= gain;
+    }
+    for (int t = 0; t < count; ++t) {
+        float sum = out[t];
+        if (norm > 0.f) sum /= norm;
+        if (sum < -1.f) sum = -1.f; else if (sum > 1.f) sum = 1.f;
+        out[t] = sum;
+    }
+}
+
+void fbmBlock(int i0, int j0, int rows, int cols, float scale, float* out,
+              uint32_t seed, int octaves, float lacunarity, float gain) {
+    thread_local std::vector<float> xs, ys;
+    xs.resize((size_t)rows);
+    ys.resize((size_t)cols);
+    for (int r = 0; r < rows; ++r) xs[(size_t)r] = (float)(i0 + r) * scale;
+    for (int c = 0; c < cols; ++c) ys[(size_t)c] = (float)(j0 + c) * scale;
+    fbmGrid(xs.data(), rows, ys.data(), cols, out, seed, octaves, lacunarity, gain);
+}
+
+const char* simdPath() { return path().name; }
+
 }
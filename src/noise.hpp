@@ -9,4 +9,29 @@ float fbm(float x, float y, uint32_t seed,
           float lacunarity = 2.0f,
           float gain = 0.5f);
 
+// Batched fbm, bit-identical to fbm() sample by sample: out[t] = fbm(xs[t], ys[t], ...) for
+// t in [0, n). Evaluates 8 (AVX2) or 4 (SSE4.1) samples at a time when the CPU has them.
+void fbmRow(const float* xs, const float* ys, int n, float* out,
+            uint32_t seed, int octaves = 5, float lacunarity = 2.0f, float gain = 0.5f);
+
+// Separable grid: out[r * cols + c] = fbm(xs[r], ys[c], ...), bit-identical. Per octave, the
+// lattice patch under the grid is hashed once; each row then lerps along x once per lattice
+// column and along y per sample (chunk generation samples ~0.01-0.2 lattice cells apart).
+void fbmGrid(const float* xs, int rows, const float* ys, int cols, float* out,
+             uint32_t seed, int octaves = 5, float lacunarity = 2.0f, float gain = 0.5f);
+
+// fbmGrid in passes: fbmGridOctaves adds octaves [first, last) to the running sums in acc
+// (zeroed before octave 0), fbmFinish normalizes them for the octave count. Passes over
+// [0, k) then [k, octaves) followed by fbmFinish match fbmGrid bit for bit.
+void fbmGridOctaves(const float* xs, int rows, const float* ys, int cols, float* acc,
+                    uint32_t seed, int first, int last, float lacunarity = 2.0f, float gain = 0.5f);
+void fbmFinish(float* acc, int count, int octaves, float gain = 0.5f);
+
+// Lattice-aligned block: out[r * cols + c] = fbm((float)(i0 + r) * scale, (float)(j0 + c) * scale, ...)
+void fbmBlock(int i0, int j0, int rows, int cols, float scale, float* out,
+              uint32_t seed, int octaves = 5, float lacunarity = 2.0f, float gain = 0.5f);
+
+// Instruction set used by the batched calls: "avx2", "sse4.1" or "scalar"
+const char* simdPath();
+
 }
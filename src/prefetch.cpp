@@ -0,0 +1,52 @@
+#include "prefetch.hpp"
+#include <algorithm>
+#include <cmath>
+
+void ChunkPrefetcher::observe(float centerI, float centerJ, float zoomScale, float dt) {
+    float logZoom = std::log(std::max(1e-3f, zoomScale));
+    if (!_hasPrev || dt <= 0.f) {
+        _hasPrev = true;
+        _prevI = centerI; _prevJ = centerJ; _prevLogZoom = logZoom;
+        return;
+    }
+    float dI = centerI - _prevI;
+    float dJ = centerJ - _prevJ;
+    _prevI = centerI; _prevJ = centerJ;
+    float dz = logZoom - _prevLogZoom;
+    _prevLogZoom = logZoom;
+    // Teleports (reset view, tilt recentering) are not motion: restart the estimate
+    if (std::fabs(dI) > 2.f * cfg::CHUNK_SIZE || std::fabs(dJ) > 2.f * cfg::CHUNK_SIZE) {
+        _velI = _velJ = _zoomRate = 0.f;
+        return;
+    }
+    // Exponential smoothing (~150 ms time constant) so single jittery frames do not dominate
+    float a = 1.f - std::exp(-dt / 0.15f);
+    _velI += (dI / dt - _velI) * a;
+    _velJ += (dJ / dt - _velJ) * a;
+    _zoomRate += (dz / dt - _zoomRate) * a;
+}
+
+ChunkPrefetcher::Prediction ChunkPrefetcher::predict() const {
+    Prediction p;
+    p.dI = _velI * _horizon;
+    p.dJ = _velJ * _horizon;
+    p.zoomFactor = std::exp(_zoomRate * _horizon);
+    // Ignore sub-chunk drift and tiny zoom changes (nothing new would become visible)
+    const float minShift = cfg::CHUNK_SIZE * 0.25f;
+    p.moving = std::fabs(p.dI) > minShift || std::fabs(p.dJ) > minShift || std::fabs(p.zoomFactor - 1.f) > 0.05f;
+    return p;
+}
+
+void ChunkPrefetcher::collect(const ChunkWindow& current, const ChunkWindow& ahead,
+                              size_t maxChunks, std::vector<ChunkKey>& out) {
+    out.clear();
+    for (int cx = ahead.cx0; cx <= ahead.cx1; ++cx) {
+        for (int cy = ahead.cy0; cy <= ahead.cy1; ++cy) {
+            if (!ahead.contains(cx, cy) || current.contains(cx, cy)) continue;
+            out.push_back(ChunkKey{cx, cy});
+        }
+    }
+    auto dist = [&](const ChunkKey& k){ return std::max(std::abs(k.cx - ahead.ccx), std::abs(k.cy - ahead.ccy)); };
+    std::sort(out.begin(), out.end(), [&](const ChunkKey& a, const ChunkKey& b){ return dist(a) < dist(b); });
+    if (out.size() > maxChunks) out.resize(maxChunks);
+}
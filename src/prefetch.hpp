@@ -0,0 +1,44 @@
+#pragma once
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+#include "chunks.hpp"
+
+// Rectangle of chunks drawn for a view, limited by a Chebyshev LOD radius around (ccx, ccy)
+struct ChunkWindow {
+    int cx0 = 0, cx1 = -1, cy0 = 0, cy1 = -1;
+    int ccx = 0, ccy = 0;
+    int radius = 0;
+    bool contains(int cx, int cy) const {
+        if (cx < cx0 || cx > cx1 || cy < cy0 || cy > cy1) return false;
+        return std::max(std::abs(cx - ccx), std::abs(cy - ccy)) <= radius;
+    }
+};
+
+// Extrapolates camera motion (pan velocity in grid units, zoom rate) to find the chunks
+// the view is heading toward, so ChunkManager can generate them before they become visible.
+class ChunkPrefetcher {
+public:
+    explicit ChunkPrefetcher(float horizonSec = cfg::PREFETCH_HORIZON_SEC) : _horizon(horizonSec) {}
+
+    void setHorizon(float seconds) { _horizon = seconds; }
+    float horizon() const { return _horizon; }
+
+    // Feed the current view center (grid coords) and zoom scale once per frame
+    void observe(float centerI, float centerJ, float zoomScale, float dt);
+
+    struct Prediction { float dI = 0.f, dJ = 0.f; float zoomFactor = 1.f; bool moving = false; };
+    // Expected view displacement and zoom change over the horizon
+    Prediction predict() const;
+
+    // Chunks of `ahead` not already in `current`, nearest to the predicted center first
+    static void collect(const ChunkWindow& current, const ChunkWindow& ahead,
+                        size_t maxChunks, std::vector<ChunkKey>& out);
+
+private:
+    float _horizon;
+    bool _hasPrev = false;
+    float _prevI = 0.f, _prevJ = 0.f, _prevLogZoom = 0.f;
+    float _velI = 0.f, _velJ = 0.f;   // grid units / second (smoothed)
+    float _zoomRate = 0.f;            // d(log zoomScale) / second (smoothed)
+};
@@ -0,0 +1,290 @@
+#include "regionfile.hpp"
+#include "chunks.hpp"
+#include "chunkstore.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+
+namespace fs = std::filesystem;
+
+namespace {
+    const char MAGIC[4] = {'M', 'W', 'R', 'G'};
+    constexpr uint16_t VERSION = 1;
+
+    inline int floorDiv(int a, int b) { return (a >= 0) ? (a / b) : ((a - (b - 1)) / b); }
+    inline void put32(uint8_t* p, uint32_t v) { for (int k = 0; k < 4; ++k) p[k] = (uint8_t)(v >> (8 * k)); }
+    inline uint32_t get32(const uint8_t* p) { return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24); }
+    inline uint32_t sectorsFor(uint32_t bytes) { return (bytes + RegionFile::SECTOR_BYTES - 1) / RegionFile::SECTOR_BYTES; }
+    inline uint64_t packKey(int cx, int cy) { return ((uint64_t)(uint32_t)cx << 32) | (uint32_t)cy; }
+}
+
+// ===== RegionFile =====
+bool RegionFile::open(const std::string& path, bool create) {
+    close();
+    _path = path;
+    const int N = SIDE * SIDE;
+    _f.open(path, std::ios::in | std::ios::out | std::ios::binary);
+    if (!_f.is_open()) {
+        if (!create) return false;
+        std::error_code ec;
+        fs::create_directories(fs::path(path).parent_path(), ec);
+        std::vector<uint8_t> header((size_t)HEADER_SECTORS * SECTOR_BYTES, 0);
+        std::memcpy(header.data(), MAGIC, 4);
+        header[4] = (uint8_t)VERSION; header[5] = (uint8_t)(VERSION >> 8);
+        header[6] = (uint8_t)SIDE;    header[7] = (uint8_t)(SIDE >> 8);
+        put32(header.data() + 8, SECTOR_BYTES);
+        {
+            std::ofstream init(path, std::ios::binary | std::ios::trunc);
+            if (!init) return false;
+            init.write(reinterpret_cast<const char*>(header.data()), (std::streamsize)header.size());
+            init.close();
+            if (!init || !syncFile(path)) return false;
+        }
+        _f.open(path, std::ios::in | std::ios::out | std::ios::binary);
+        if (!_f.is_open()) return false;
+    }
+    std::vector<uint8_t> header(HEADER_BYTES);
+    _f.seekg(0);
+    _f.read(reinterpret_cast<char*>(header.data()), (std::streamsize)header.size());
+    bool ok = (bool)_f
+        && std::memcmp(header.data(), MAGIC, 4) == 0
+        && (header[4] | (header[5] << 8)) == VERSION
+        && (header[6] | (header[7] << 8)) == SIDE
+        && get32(header.data() + 8) == SECTOR_BYTES;
+    if (!ok) { close(); return false; } // never overwrite a file we do not understand
+    _f.seekg(0, std::ios::end);
+    uint32_t fileSectors = sectorsFor((uint32_t)_f.tellg());
+    _first.assign(N, 0);
+    _length.assign(N, 0);
+    _used.assign(std::max(fileSectors, HEADER_SECTORS), 0);
+    std::fill(_used.begin(), _used.begin() + HEADER_SECTORS, 1);
+    // Sector owners per entry; entries sharing a sector are corrupt (one write would tear
+    // the other) and are all treated as empty
+    std::vector<uint8_t> owners(_used.size(), 0);
+    for (int s = 0; s < N; ++s) {
+        uint32_t first = get32(header.data() + 16 + 8 * s);
+        uint32_t len = get32(header.data() + 16 + 8 * s + 4);
+        if (first == 0 || len == 0) continue;
+        uint32_t n = sectorsFor(len);
+        if (first < HEADER_SECTORS || (size_t)first + n > _used.size()) continue; // corrupt entry: treat as empty
+        _first[s] = first;
+        _length[s] = len;
+        for (uint32_t k = first; k < first + n; ++k) owners[k] = (uint8_t)std::min(2, owners[k] + 1);
+    }
+    for (int s = 0; s < N; ++s) {
+        if (_first[s] == 0) continue;
+        const uint32_t first = _first[s], n = sectorsFor(_length[s]);
+        if (std::any_of(owners.begin() + first, owners.begin() + first + n, [](uint8_t o){ return o > 1; })) {
+            _first[s] = 0; _length[s] = 0;
+        }
+    }
+    for (int s = 0; s < N; ++s)
+        if (_first[s]) std::fill(_used.begin() + _first[s], _used.begin() + _first[s] + sectorsFor(_length[s]), 1);
+    return true;
+}
+
+const uint8_t* RegionFile::view(int lx, int ly, size_t& size) {
+    int s = slot(lx, ly);
+    if (!_f.is_open() || _first[s] == 0) return nullptr;
+    if (!_map.valid() && !_map.open(_path)) return nullptr;
+    const size_t at = (size_t)_first[s] * SECTOR_BYTES;
+    if (at + _length[s] > _map.size()) return nullptr;
+    size = _length[s];
+    return _map.data() + at;
+}
+
+bool RegionFile::read(int lx, int ly, std::vector<uint8_t>& out) {
+    size_t size = 0;
+    const uint8_t* p = view(lx, ly, size);
+    if (!p) return false;
+    out.assign(p, p + size);
+    return true;
+}
+
+uint32_t RegionFile::allocate(uint32_t sectors) {
+    // First fit among freed sectors, else grow the file
+    uint32_t run = 0;
+    for (uint32_t k = HEADER_SECTORS; k < (uint32_t)_used.size(); ++k) {
+        run = _used[k] ? 0 : run + 1;
+        if (run == sectors) {
+            uint32_t first = k + 1 - sectors;
+            std::fill(_used.begin() + first, _used.begin() + first + sectors, 1);
+            return first;
+        }
+    }
+    uint32_t first = (uint32_t)_used.size();
+    _used.resize(_used.size() + sectors, 1);
+    return first;
+}
+
+void RegionFile::release(uint32_t first, uint32_t sectors) {
+    if (first == 0) return;
+    std::fill(_used.begin() + first, _used.begin() + std::min<size_t>(_used.size(), (size_t)first + sectors), 0);
+}
+
+bool RegionFile::writeTableEntry(int s) {
+    uint8_t e[8];
+    put32(e, _first[s]);
+    put32(e + 4, _length[s]);
+    _f.clear();
+    _f.seekp(16 + 8 * (std::streamoff)s);
+    _f.write(reinterpret_cast<const char*>(e), 8);
+    _f.flush();
+    return _f && syncFile(_path);
+}
+
+bool RegionFile::write(int lx, int ly, const uint8_t* data, size_t size) {
+    if (!_f.is_open()) return false;
+    _map.close(); // the file changes (and may grow) under it
+    int s = slot(lx, ly);
+    const uint32_t oldFirst = _first[s];
+    const uint32_t oldN = oldFirst ? sectorsFor(_length[s]) : 0;
+    if (size == 0) {
+        if (oldFirst == 0) return true;
+        _first[s] = 0; _length[s] = 0;
+        if (!writeTableEntry(s)) return false;
+        release(oldFirst, oldN);
+        return true;
+    }
+    // Copy-on-write: the blob goes to sectors outside the live slot (still marked used), the
+    // table entry is switched once the data is synced to disk, and the entry is synced before
+    // the old run is freed. A crash, power loss or short write at any point leaves either the
+    // previous blob or the new one intact.
+    uint32_t n = sectorsFor((uint32_t)size);
+    uint32_t first = allocate(n);
+    // Pad to a whole sector so the file length stays sector-aligned
+    std::vector<uint8_t> buf((size_t)n * SECTOR_BYTES, 0);
+    std::memcpy(buf.data(), data, size);
+    _f.clear();
+    _f.seekp((std::streamoff)first * SECTOR_BYTES);
+    _f.write(reinterpret_cast<const char*>(buf.data()), (std::streamsize)buf.size());
+    _f.flush();
+    if (!_f || !syncFile(_path)) { release(first, n); return false; }
+    _first[s] = first;
+    _length[s] = (uint32_t)size;
+    if (!writeTableEntry(s)) {
+        // The entry on disk may still point at the old run: keep both reserved
+        return false;
+    }
+    release(oldFirst, oldN);
+    return true;
+}
+
+// ===== RegionStore =====
+RegionFile* RegionStore::regionFor(const std::string& dir, int cx, int cy, bool create) {
+    int rx = floorDiv(cx, RegionFile::SIDE);
+    int ry = floorDiv(cy, RegionFile::SIDE);
+    std::string path = dir + "/r." + std::to_string(rx) + "." + std::to_string(ry) + ".mwr";
+    auto it = _byPath.find(path);
+    if (it != _byPath.end()) {
+        _open.splice(_open.begin(), _open, it->second);
+    } else {
+        // Missing files stay cached as closed handles, so misses do not hit the filesystem again
+        _open.push_front(Open{path, RegionFile{}});
+        _byPath[path] = _open.begin();
+        _open.front().file.open(path, false);
+        while (_open.size() > (size_t)cfg::REGION_OPEN_FILES) {
+            _byPath.erase(_open.back().path);
+            _open.pop_back();
+        }
+    }
+    RegionFile& rf = _open.front().file;
+    if (!rf.isOpen() && create) rf.open(path, true);
+    return rf.isOpen() ? &rf : nullptr;
+}
+
+bool RegionStore::load(const std::string& dir, int cx, int cy, Chunk& ch) {
+    std::lock_guard<std::mutex> lk(_mtx);
+    RegionFile* rf = regionFor(dir, cx, cy, false);
+    size_t size = 0;
+    const uint8_t* blob = rf ? rf->view(cx - floorDiv(cx, RegionFile::SIDE) * RegionFile::SIDE,
+                                        cy - floorDiv(cy, RegionFile::SIDE) * RegionFile::SIDE, size) : nullptr;
+    if (blob) return chunkstore::decode(blob, size, ch);
+    // Not migrated yet: read the legacy file in place of the slot
+    const auto& legacy = legacyIn(dir);
+    auto it = legacy.find(packKey(cx, cy));
+    return it != legacy.end() && readLegacy(it->second, ch);
+}
+
+bool RegionStore::save(const std::string& dir, int cx, int cy, const std::vector<uint8_t>& blob) {
+    std::lock_guard<std::mutex> lk(_mtx);
+    RegionFile* rf = regionFor(dir, cx, cy, !blob.empty());
+    if (!rf) return blob.empty(); // clearing a slot of a region that does not exist
+    return rf->write(cx - floorDiv(cx, RegionFile::SIDE) * RegionFile::SIDE,
+                     cy - floorDiv(cy, RegionFile::SIDE) * RegionFile::SIDE, blob.data(), blob.size());
+}
+
+void RegionStore::dropDir(const std::string& dir) {
+    std::lock_guard<std::mutex> lk(_mtx);
+    const std::string prefix = dir + "/";
+    for (auto it = _open.begin(); it != _open.end(); ) {
+        if (it->path.compare(0, prefix.size(), prefix) == 0) {
+            _byPath.erase(it->path);
+            it = _open.erase(it); // closes the file
+        } else {
+            ++it;
+        }
+    }
+    _legacy.erase(dir);
+    std::error_code ec;
+    fs::remove_all(fs::path(dir), ec); // ignore errors
+}
+
+const std::unordered_map<uint64_t, RegionStore::Legacy>& RegionStore::legacyIn(const std::string& dir) {
+    auto found = _legacy.find(dir);
+    if (found != _legacy.end()) return found->second;
+    auto& out = _legacy[dir];
+    std::error_code ec;
+    for (const auto& de : fs::directory_iterator(fs::path(dir), ec)) {
+        if (!de.is_regular_file(ec)) continue;
+        std::string ext = de.path().extension().string();
+        if (ext != ".mwc" && ext != ".csv") continue;
+        std::string stem = de.path().stem().string();
+        int cx = 0, cy = 0;
+        char tail = 0;
+        if (std::sscanf(stem.c_str(), "c%d_%d%c", &cx, &cy, &tail) != 2) continue;
+        Legacy& l = out[packKey(cx, cy)];
+        (ext == ".mwc" ? l.mwc : l.csv) = de.path().string();
+    }
+    return out;
+}
+
+void RegionStore::closeAll() {
+    std::lock_guard<std::mutex> lk(_mtx);
+    _byPath.clear();
+    _open.clear();
+}
+
+bool RegionStore::readLegacy(const Legacy& l, Chunk& ch) {
+    return !l.mwc.empty() ? chunkstore::loadBinary(l.mwc, ch) : chunkstore::loadCsv(l.csv, ch);
+}
+
+int RegionStore::migrateLegacy(const std::string& dir) {
+    std::lock_guard<std::mutex> lk(_mtx);
+    const std::unordered_map<uint64_t, Legacy> legacy = legacyIn(dir);
+    _legacy.erase(dir); // rescanned on next access: only what stayed unconverted is left
+    int imported = 0;
+    std::vector<uint8_t> blob, back;
+    std::error_code ec;
+    for (const auto& kv : legacy) {
+        const int cx = (int)(kv.first >> 32), cy = (int)(uint32_t)kv.first;
+        const Legacy& l = kv.second;
+        RegionFile* rf = regionFor(dir, cx, cy, true);
+        if (!rf) continue;
+        int lx = cx - floorDiv(cx, RegionFile::SIDE) * RegionFile::SIDE;
+        int ly = cy - floorDiv(cy, RegionFile::SIDE) * RegionFile::SIDE;
+        if (!rf->read(lx, ly, back)) { // region data is newer than any leftover file
+            Chunk ch;
+            if (!readLegacy(l, ch)) continue;
+            chunkstore::encode(ch, blob);
+            if (!rf->write(lx, ly, blob.data(), blob.size())) continue;
+            // Keep the sources unless the slot reads back exactly what was imported
+            if (!rf->read(lx, ly, back) || back != blob) continue;
+            ++imported;
+        }
+        for (const std::string& src : {l.mwc, l.csv})
+            if (!src.empty()) fs::rename(src, src + ".bak", ec);
+    }
+    return imported;
+}
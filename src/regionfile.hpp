@@ -0,0 +1,85 @@
+#pragma once
+#include <cstdint>
+#include <fstream>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "config.hpp"
+#include "mmapfile.hpp"
+
+class Chunk;
+
+// Region container: REGION_CHUNKS x REGION_CHUNKS chunk-override blobs in one file
+// maps/seed_<seed>[_cont]/r.<rx>.<ry>.mwr, little-endian:
+//   header  16 bytes: magic "MWRG", u16 version, u16 region side, u32 sector bytes, u32 reserved
+//   table   side*side x {u32 first sector (0 = empty slot), u32 byte length}
+//   data    blobs aligned on SECTOR_BYTES sectors, header+table occupying the first sectors
+// Free space is tracked with an in-memory sector bitmap rebuilt from the table on open;
+// entries whose sector runs overlap are rejected (read as empty).
+class RegionFile {
+public:
+    static constexpr int SIDE = cfg::REGION_CHUNKS;
+    static constexpr uint32_t SECTOR_BYTES = 512;
+    static constexpr uint32_t HEADER_BYTES = 16 + 8 * SIDE * SIDE;
+    static constexpr uint32_t HEADER_SECTORS = (HEADER_BYTES + SECTOR_BYTES - 1) / SECTOR_BYTES;
+
+    // create=false: fails when the file does not exist
+    bool open(const std::string& path, bool create);
+    bool isOpen() const { return _f.is_open(); }
+    void close() { _map.close(); if (_f.is_open()) _f.close(); }
+
+    // Slot coordinates are region-local (0..SIDE-1). view() points into the mapped file (valid
+    // until the next write or close), nullptr for empty slots; read() copies the blob out.
+    const uint8_t* view(int lx, int ly, size_t& size);
+    bool read(int lx, int ly, std::vector<uint8_t>& out);
+    // Never overwrites the slot's live sectors: the blob is written elsewhere and synced to disk,
+    // then the table entry switches to it and is synced, then the old run is freed. Size 0
+    // clears the slot.
+    bool write(int lx, int ly, const uint8_t* data, size_t size);
+
+private:
+    std::fstream _f;
+    std::string _path;
+    MappedFile _map; // read-only view, dropped by writes and remapped on the next read
+    std::vector<uint32_t> _first, _length;  // offset table
+    std::vector<uint8_t> _used;             // sector occupancy
+    static int slot(int lx, int ly) { return lx * SIDE + ly; }
+    uint32_t allocate(uint32_t sectors);
+    void release(uint32_t first, uint32_t sectors);
+    bool writeTableEntry(int s);
+};
+
+// Thread-safe access to the region files of any world directory, with a small LRU of
+// open handles (cfg::REGION_OPEN_FILES). Legacy per-chunk files (cX_Y.mwc / cX_Y.csv) are
+// only read: a chunk without a region slot loads from them (the region slot, once written,
+// wins). Folding them into regions is explicit (migrateLegacy, bin/mapconv).
+class RegionStore {
+public:
+    // Decodes the chunk's override blob (see chunkstore.hpp) into ch straight from the mapped
+    // region file; false when the chunk has none
+    bool load(const std::string& dir, int cx, int cy, Chunk& ch);
+    // Empty blob clears the slot
+    bool save(const std::string& dir, int cx, int cy, const std::vector<uint8_t>& blob);
+    // Closes the handles of dir and deletes the directory
+    void dropDir(const std::string& dir);
+    // Imports legacy per-chunk files of dir into region files; returns the number imported.
+    // A source is renamed to <name>.bak once its region slot reads back identical (or already
+    // held newer data); nothing is deleted.
+    int migrateLegacy(const std::string& dir);
+    void closeAll();
+
+private:
+    struct Open { std::string path; RegionFile file; };
+    std::mutex _mtx;
+    std::list<Open> _open; // most-recent at front
+    std::unordered_map<std::string, std::list<Open>::iterator> _byPath;
+    // Legacy per-chunk files of each directory accessed, scanned once (packed cx/cy key)
+    struct Legacy { std::string mwc, csv; }; // the binary file wins when both exist
+    std::unordered_map<std::string, std::unordered_map<uint64_t, Legacy>> _legacy;
+
+    RegionFile* regionFor(const std::string& dir, int cx, int cy, bool create); // _mtx held
+    const std::unordered_map<uint64_t, Legacy>& legacyIn(const std::string& dir); // _mtx held
+    static bool readLegacy(const Legacy& l, Chunk& ch);
+};
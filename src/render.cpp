@@ -1,5 +1,6 @@
 #include "render.hpp"
 #include "config.hpp"
+#include "gridlayout.hpp"
 #include <algorithm>
 #include <cmath>
 #include <cstdint>
@@ -137,7 +138,7 @@ void draw2DFilledCells(sf::RenderTarget& target,
         float horizLen = std::sqrt(Ldir.x * Ldir.x + Ldir.y * Ldir.y);
         float elev = std::atan2(std::max(1e-4f, Ldir.z), std::max(1e-4f, horizLen)); // elevation above horizon
         const float risePerStep = (float)std::max(0.02f, std::tan(elev)); // allow small values for longer shadows
-        const int maxSteps = 96;
+        const int maxSteps = cfg::SHADOW_STEPS;
 
         // March from each cell towards the light source; if any encountered terrain
         // is above the rising reference line, the cell is shadowed.
@@ -331,12 +332,13 @@ void draw2DFilledCells(sf::RenderTarget& target,
 // -------- Per-chunk variants --------
 
 std::vector<std::vector<sf::Vector2f>> buildProjectedMapChunk(
-    const std::vector<int>& heights,
+    const int16_t* heights,
     int S,
     int I0, int J0,
     const IsoParams& iso,
     const sf::Vector2f& origin,
-    float heightScale)
+    float heightScale,
+    int step)
 {
     const int W = S + 1;
     auto idc = [&](int i, int j){ return i * W + j; };
@@ -344,7 +346,7 @@ std::vector<std::vector<sf::Vector2f>> buildProjectedMapChunk(
     for (int i = 0; i <= S; ++i) {
         for (int j = 0; j <= S; ++j) {
             int h = heights[idc(i, j)];
-            map2d[i][j] = isoProjectDyn((float)(I0 + i), (float)(J0 + j), (h * heightScale) * cfg::ELEV_STEP, iso) + origin;
+            map2d[i][j] = isoProjectDyn((float)(I0 + i * step), (float)(J0 + j * step), (h * heightScale) * cfg::ELEV_STEP, iso) + origin;
         }
     }
     return map2d;
@@ -391,19 +393,22 @@ void draw2DMapChunk(sf::RenderTarget& target,
 
 void draw2DFilledCellsChunk(sf::RenderTarget& target,
                             const std::vector<std::vector<sf::Vector2f>>& map2d,
-                            const std::vector<int>& heights,
+                            const int16_t* heights,
+                            const int16_t* halo,
                             int S,
                             bool enableShadows,
                             float heightScale,
                             int I0, int J0,
                             const std::unordered_map<long long, sf::Color>* paintedCells,
                             const std::unordered_set<long long>* hoverMask,
-                            const sf::Color* hoverColor)
+                            const sf::Color* hoverColor,
+                            int step)
 {
     int H = (int)map2d.size();
     if (H == 0) return;
     int W = (int)map2d[0].size();
     auto idc = [&](int i, int j){ return i * W + j; };
+    if (step > 1) halo = nullptr; // the halo holds full-resolution neighbour rows
 
     const auto& view = target.getView();
     sf::Vector2f vc = view.getCenter();
@@ -432,11 +437,12 @@ void draw2DFilledCellsChunk(sf::RenderTarget& target,
         if (len2 > 0.f) { lightDirGrid.x /= len2; lightDirGrid.y /= len2; } else { lightDirGrid = sf::Vector2f(-1.f, -1.f); }
         float horizLen = std::sqrt(Ldir.x * Ldir.x + Ldir.y * Ldir.y);
         float elev = std::atan2(std::max(1e-4f, Ldir.z), std::max(1e-4f, horizLen));
-        const float risePerStep = (float)std::max(0.02f, std::tan(elev));
-        const int maxSteps = 96;
+        // March in vertices: a coarse vertex spans step tiles, the same reach in world space
+        const float risePerStep = (float)std::max(0.02f, std::tan(elev)) * (float)step;
+        const int maxSteps = cfg::SHADOW_STEPS / step;
         for (int i = 0; i < H; ++i) {
             for (int j = 0; j < W; ++j) {
-                float baseH = (float)std::clamp(heights[idc(i, j)], cfg::MIN_ELEV, cfg::MAX_ELEV);
+                float baseH = (float)std::clamp((int)heights[idc(i, j)], cfg::MIN_ELEV, cfg::MAX_ELEV);
                 float x = (float)i;
                 float y = (float)j;
                 float refH = baseH - 0.02f;
@@ -447,8 +453,15 @@ void draw2DFilledCellsChunk(sf::RenderTarget& target,
                     refH += risePerStep;
                     int ii = (int)std::floor(x + 0.5f);
                     int jj = (int)std::floor(y + 0.5f);
-                    if (!inBounds(ii, jj)) break;
-                    float h = (float)std::clamp(heights[idc(ii, jj)], cfg::MIN_ELEV, cfg::MAX_ELEV);
+                    int hv;
+                    if (inBounds(ii, jj)) {
+                        hv = heights[idc(ii, jj)];
+                    } else if (halo && ii >= 0 && ii < H && jj < 0 && jj >= -cfg::SHADOW_HALO) {
+                        hv = halo[layout::Halo<cfg::SHADOW_HALO>::index(ii, jj)];
+                    } else {
+                        break;
+                    }
+                    float h = (float)std::clamp(hv, cfg::MIN_ELEV, cfg::MAX_ELEV);
                     if (h > refH) { shadowed = true; break; }
                 }
                 shadowMask[id(i, j)] = shadowed ? 1 : 0;
@@ -507,10 +520,11 @@ void draw2DFilledCellsChunk(sf::RenderTarget& target,
         float hB = (float)heights[idc(std::min(i + stride, H - 1), j)] * heightScale;
         float hC = (float)heights[idc(std::min(i + stride, H - 1), std::min(j + stride, W - 1))] * heightScale;
         float hD = (float)heights[idc(i, std::min(j + stride, W - 1))] * heightScale;
-        sf::Vector3f A3((float)i,               (float)j,               hA * cfg::ELEV_STEP);
-        sf::Vector3f B3((float)std::min(i+stride, H-1), (float)j,               hB * cfg::ELEV_STEP);
-        sf::Vector3f C3((float)std::min(i+stride, H-1), (float)std::min(j+stride, W-1), hC * cfg::ELEV_STEP);
-        sf::Vector3f D3((float)i,               (float)std::min(j+stride, W-1), hD * cfg::ELEV_STEP);
+        const float g = (float)step; // world tiles per vertex
+        sf::Vector3f A3((float)i * g,               (float)j * g,               hA * cfg::ELEV_STEP);
+        sf::Vector3f B3((float)std::min(i+stride, H-1) * g, (float)j * g,               hB * cfg::ELEV_STEP);
+        sf::Vector3f C3((float)std::min(i+stride, H-1) * g, (float)std::min(j+stride, W-1) * g, hC * cfg::ELEV_STEP);
+        sf::Vector3f D3((float)i * g,               (float)std::min(j+stride, W-1) * g, hD * cfg::ELEV_STEP);
         auto sub = [](sf::Vector3f a, sf::Vector3f b){ return sf::Vector3f(a.x-b.x, a.y-b.y, a.z-b.z); };
         auto cross = [](sf::Vector3f a, sf::Vector3f b){ return sf::Vector3f(a.y*b.z - a.z*b.y, a.z*b.x - a.x*b.z, a.x*b.y - a.y*b.x); };
         sf::Vector3f n1 = norm3(cross(sub(B3, A3), sub(C3, A3)));
@@ -548,7 +562,7 @@ void draw2DFilledCellsChunk(sf::RenderTarget& target,
             }
             // Prefer painted color for world cell (I0+i, J0+j); then apply hover tint if inside hoverMask
             auto base = colorForHeight(hAvg);
-            long long key = (((long long)(I0 + i)) << 32) ^ (unsigned long long)(uint32_t)(J0 + j);
+            long long key = (((long long)(I0 + i * step)) << 32) ^ (unsigned long long)(uint32_t)(J0 + j * step);
             if (paintedCells) {
                 auto it = paintedCells->find(key);
                 if (it != paintedCells->end()) base = it->second;
@@ -1,5 +1,6 @@
 #pragma once
 #include <SFML/Graphics.hpp>
+#include <cstdint>
 #include <vector>
 #include <unordered_map>
 #include <unordered_set>
@@ -25,26 +26,30 @@ namespace render {
                            const sf::Color* hoverColor = nullptr);
 
     // --- Per-chunk rendering (arbitrary size S=(side-1)) ---
+    // step: world tiles between consecutive vertices (a coarse level, ChunkManager::levelStride)
     std::vector<std::vector<sf::Vector2f>> buildProjectedMapChunk(
-        const std::vector<int>& heights, // size (S+1)*(S+1)
+        const int16_t* heights, // size (S+1)*(S+1), chunk storage as is
         int S,
         int I0, int J0,               // world origin (grid coords) of this chunk
         const IsoParams& iso,
         const sf::Vector2f& origin,
-        float heightScale);
+        float heightScale,
+        int step = 1);
 
     void draw2DMapChunk(sf::RenderTarget& target,
                         const std::vector<std::vector<sf::Vector2f>>& map2d);
 
     void draw2DFilledCellsChunk(sf::RenderTarget& target,
                                 const std::vector<std::vector<sf::Vector2f>>& map2d,
-                                const std::vector<int>& heights,
+                                const int16_t* heights,
+                                const int16_t* halo, // neighbour heights before each row along j (Chunk::halo), or null
                                 int S,
                                 bool enableShadows,
                                 float heightScale,
                                 int I0 = 0, int J0 = 0,
                                 const std::unordered_map<long long, sf::Color>* paintedCells = nullptr,
                                 const std::unordered_set<long long>* hoverMask = nullptr,
-                                const sf::Color* hoverColor = nullptr);
+                                const sf::Color* hoverColor = nullptr,
+                                int step = 1); // coarse level: no halo, painted colors by each quad's first cell
 }
 
@@ -2,6 +2,10 @@
 #include <vector>
 #include <cstdint>
 
+class ThreadPool;
+
 namespace terrain {
-    void generateMap(std::vector<int>& heights, uint32_t seed);
+    // Fills the (GRID+1)^2 map. With a pool, row bands run on its workers and the calling
+    // thread (same result for any thread count); without one, on the calling thread only.
+    void generateMap(std::vector<int>& heights, uint32_t seed, ThreadPool* pool = nullptr);
 }
@@ -0,0 +1,73 @@
+#include "threadpool.hpp"
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+ThreadPool::ThreadPool(unsigned threads) {
+    if (threads == 0) {
+        unsigned hw = std::thread::hardware_concurrency();
+        threads = std::max(1u, hw > 1 ? hw - 1 : 1u);
+    }
+    _workers.reserve(threads);
+    for (unsigned t = 0; t < threads; ++t) {
+        _workers.emplace_back([this]{ workerLoop(); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lk(_mtx);
+        _stop = true;
+        _tasks.clear();
+    }
+    _cv.notify_all();
+    for (auto& w : _workers) w.join();
+}
+
+void ThreadPool::submit(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lk(_mtx);
+        if (_stop) return;
+        _tasks.push_back(std::move(task));
+    }
+    _cv.notify_one();
+}
+
+void ThreadPool::parallelFor(int count, const std::function<void(int)>& body) {
+    if (count <= 0) return;
+    // Shared with the helper tasks: one may start after the batch is over and must find it drained
+    struct Batch {
+        std::atomic<int> next{0};
+        int done = 0;
+        std::mutex mtx;
+        std::condition_variable cv;
+    };
+    auto batch = std::make_shared<Batch>();
+    auto drain = [batch, count, &body] {
+        int ran = 0;
+        for (int k; (k = batch->next.fetch_add(1)) < count; ++ran) body(k);
+        if (ran == 0) return;
+        std::lock_guard<std::mutex> lk(batch->mtx);
+        batch->done += ran;
+        if (batch->done == count) batch->cv.notify_all();
+    };
+    const int helpers = std::min(count - 1, (int)_workers.size());
+    for (int h = 0; h < helpers; ++h) submit(drain);
+    drain();
+    std::unique_lock<std::mutex> lk(batch->mtx);
+    batch->cv.wait(lk, [&]{ return batch->done == count; });
+}
+
+void ThreadPool::workerLoop() {
+    for (;;) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lk(_mtx);
+            _cv.wait(lk, [this]{ return _stop || !_tasks.empty(); });
+            if (_stop) return;
+            task = std::move(_tasks.front());
+            _tasks.pop_front();
+        }
+        task();
+    }
+}
@@ -0,0 +1,34 @@
+#pragma once
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Minimal fixed-size worker pool (FIFO task queue).
+// Tasks still queued at destruction are dropped; running ones are joined.
+class ThreadPool {
+public:
+    // threads == 0 => hardware_concurrency - 1 (at least 1)
+    explicit ThreadPool(unsigned threads = 0);
+    ~ThreadPool();
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    void submit(std::function<void()> task);
+    // Runs body(k) for k in [0, count) on the workers and the calling thread, and returns once
+    // every call is done. Indices are claimed in order but run concurrently: body must only
+    // write state owned by its index. Safe from a worker task (the caller drains the batch).
+    void parallelFor(int count, const std::function<void(int)>& body);
+    unsigned size() const { return (unsigned)_workers.size(); }
+
+private:
+    std::vector<std::thread> _workers;
+    std::deque<std::function<void()>> _tasks;
+    std::mutex _mtx;
+    std::condition_variable _cv;
+    bool _stop = false;
+
+    void workerLoop();
+};
@@ -0,0 +1,72 @@
+#include "writebehind.hpp"
+
+WriteBehind::WriteBehind(RegionStore& store, size_t capacity)
+    : _store(store), _capacity(capacity < 1 ? 1 : capacity) {
+    _thread = std::thread([this]{ run(); });
+}
+
+WriteBehind::~WriteBehind() {
+    {
+        std::lock_guard<std::mutex> lk(_mtx);
+        _stop = true;
+    }
+    _cvWork.notify_all();
+    _thread.join();
+}
+
+void WriteBehind::enqueue(const std::string& dir, int cx, int cy, std::vector<uint8_t>&& blob) {
+    Key key{dir, cx, cy};
+    Blob snap = std::make_shared<const std::vector<uint8_t>>(std::move(blob));
+    std::unique_lock<std::mutex> lk(_mtx);
+    auto it = _pending.find(key);
+    if (it == _pending.end()) {
+        // Backpressure: wait for the writer to catch up
+        _cvSpace.wait(lk, [this]{ return _pending.size() < _capacity; });
+        it = _pending.emplace(key, Pending{}).first;
+    }
+    Pending& p = it->second;
+    p.blob = std::move(snap);
+    p.seq = _nextSeq++;
+    if (!p.queued) { p.queued = true; _order.push_back(key); }
+    lk.unlock();
+    _cvWork.notify_one();
+}
+
+bool WriteBehind::pending(const std::string& dir, int cx, int cy, Blob& out) {
+    std::lock_guard<std::mutex> lk(_mtx);
+    auto it = _pending.find(Key{dir, cx, cy});
+    if (it == _pending.end()) return false;
+    out = it->second.blob;
+    return true;
+}
+
+void WriteBehind::flush() {
+    std::unique_lock<std::mutex> lk(_mtx);
+    _cvSpace.wait(lk, [this]{ return _pending.empty(); });
+}
+
+size_t WriteBehind::queued() {
+    std::lock_guard<std::mutex> lk(_mtx);
+    return _pending.size();
+}
+
+void WriteBehind::run() {
+    std::unique_lock<std::mutex> lk(_mtx);
+    for (;;) {
+        _cvWork.wait(lk, [this]{ return _stop || !_order.empty(); });
+        if (_order.empty()) return; // stopping and fully drained
+        Key key = std::move(_order.front());
+        _order.pop_front();
+        Pending& p = _pending.at(key);
+        p.queued = false;
+        Blob blob = p.blob;
+        uint64_t seq = p.seq;
+        lk.unlock();
+        _store.save(key.dir, key.cx, key.cy, *blob);
+        lk.lock();
+        // A newer snapshot may have arrived while writing; it stays pending
+        auto it = _pending.find(key);
+        if (it != _pending.end() && it->second.seq == seq) _pending.erase(it);
+        _cvSpace.notify_all();
+    }
+}
@@ -0,0 +1,61 @@
+#pragma once
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "regionfile.hpp"
+
+// Background writer for chunk-override blobs. Callers hand over an immutable snapshot and
+// return immediately; a dedicated thread writes it to the RegionStore. Snapshots of the same
+// chunk coalesce (latest wins). The queue is bounded: enqueue() blocks while it is full.
+// Unwritten snapshots stay visible through pending() so reloads never see stale data.
+class WriteBehind {
+public:
+    using Blob = std::shared_ptr<const std::vector<uint8_t>>;
+
+    WriteBehind(RegionStore& store, size_t capacity);
+    ~WriteBehind(); // writes everything still queued, then joins
+    WriteBehind(const WriteBehind&) = delete;
+    WriteBehind& operator=(const WriteBehind&) = delete;
+
+    void enqueue(const std::string& dir, int cx, int cy, std::vector<uint8_t>&& blob);
+    // Latest snapshot not yet on disk for this chunk, if any
+    bool pending(const std::string& dir, int cx, int cy, Blob& out);
+    // Blocks until everything enqueued so far has been written
+    void flush();
+
+    size_t queued();
+
+private:
+    struct Key {
+        std::string dir; int cx; int cy;
+        bool operator==(const Key& o) const { return cx == o.cx && cy == o.cy && dir == o.dir; }
+    };
+    struct KeyHash {
+        size_t operator()(const Key& k) const noexcept {
+            size_t h = std::hash<std::string>()(k.dir);
+            h ^= (size_t)(uint32_t)k.cx * 0x9E3779B97F4A7C15ULL + (h << 6) + (h >> 2);
+            h ^= (size_t)(uint32_t)k.cy * 0xC2B2AE3D27D4EB4FULL + (h << 6) + (h >> 2);
+            return h;
+        }
+    };
+    struct Pending { Blob blob; uint64_t seq = 0; bool queued = false; };
+
+    RegionStore& _store;
+    size_t _capacity;
+    std::mutex _mtx;
+    std::condition_variable _cvWork;   // writer: work available / stop
+    std::condition_variable _cvSpace;  // producers and flush(): entries written
+    std::unordered_map<Key, Pending, KeyHash> _pending;
+    std::deque<Key> _order;            // FIFO of keys with an unwritten snapshot
+    uint64_t _nextSeq = 1;
+    bool _stop = false;
+    std::thread _thread;
+
+    void run();
+};
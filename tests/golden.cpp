@@ -0,0 +1,279 @@
+// golden - generation determinism check against checked-in reference terrain
+// Usage: golden <golden.txt> [--update]
+// Regenerates fixed noise samples, chunks (seed, continents, chunk coordinates) and
+// terrain::generateMap maps, and compares them to the golden file. Chunks are also generated
+// in the background (preview pass, then refinement), which must give the same heights. Chunks and noise samples
+// are stored in full, so a mismatch names the first differing vertex; maps (301x301) are
+// stored as one hash per row, so a mismatch names the first differing row.
+// --update rewrites the golden file from the current code (only after checking the change
+// is meant to alter terrain: persisted edits in maps/seed_* are relative to it).
+#include "chunks.hpp"
+#include "noise.hpp"
+#include "terrain.hpp"
+#include "threadpool.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+struct ChunkCase { uint32_t seed; bool continents; int cx, cy; };
+const ChunkCase CHUNKS[] = {
+    {15607u, false, -5, -28}, // has persisted edits in maps/seed_15607
+    {15607u, false, 0, 0},
+    {15607u, false, -1, -1},
+    {11525u, true, 21, 56},   // has persisted edits in maps/seed_11525_cont
+    {11525u, true, -3, 7},
+    {1337u, false, 2, -9},
+    {1337u, true, 2, -9},
+    {1337u, true, -40, 1000},
+};
+const uint32_t MAP_SEEDS[] = {1337u, 15607u};
+const int NOISE_SAMPLES = 64;
+
+uint64_t fnv(uint64_t h, uint32_t v, int bytes) {
+    for (int b = 0; b < bytes; ++b) { h ^= (v >> (8 * b)) & 0xFFu; h *= 1099511628211ULL; }
+    return h;
+}
+const uint64_t FNV0 = 1469598103934665603ULL;
+
+// One generated case: a header line, then its data lines
+struct Case {
+    std::string header;          // e.g. "chunk 15607 0 -5 -28"
+    uint64_t hash = FNV0;
+    std::vector<std::string> rows;
+};
+
+std::string hex(uint64_t v, int digits) {
+    char buf[32];
+    std::snprintf(buf, sizeof buf, "%0*llx", digits, (unsigned long long)v);
+    return buf;
+}
+
+// fbm at a spread of coordinates (negative, far from the origin, every octave count)
+Case noiseCase() {
+    Case c;
+    c.header = "noise " + std::to_string(NOISE_SAMPLES);
+    std::string line;
+    for (int t = 0; t < NOISE_SAMPLES; ++t) {
+        const float x = (float)(t * 37 - 1200) * 0.173f, y = (float)(t * t - 900) * 0.0117f;
+        const float v = noise::fbm(x, y, 15607u + (uint32_t)t, 1 + t % 6);
+        uint32_t bits;
+        std::memcpy(&bits, &v, sizeof bits);
+        c.hash = fnv(c.hash, bits, 4);
+        line += (t ? " " : "") + hex(bits, 8);
+    }
+    c.rows.push_back(line);
+    return c;
+}
+
+// Chunk generated by the background requests of a view (ChunkManager::tryPin), in passes
+bool staged(const ChunkCase& k, std::vector<int16_t>& heights) {
+    ChunkManager mgr(2);
+    mgr.setMode(ChunkManager::Mode::Procedural, k.seed);
+    mgr.setContinents(k.continents);
+    mgr.setViewFocus(k.cx, k.cy, 1);
+    for (int spin = 0; spin < 20000; ++spin) {
+        mgr.pumpCompleted();
+        if (ChunkManager::Pin pin = mgr.tryPin(k.cx, k.cy, ChunkManager::Layer::Generated)) {
+            heights.assign(pin->heightData(), pin->heightData() + ChunkPool::VERTS);
+            return true;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return false;
+}
+
+// Chunks of one world, generated as a parallel batch (ChunkManager::generateChunks)
+std::vector<Case> chunkCases(std::string& err) {
+    std::vector<Case> out;
+    const int N = cfg::CHUNK_SIZE + 1;
+    for (const ChunkCase& k : CHUNKS) {
+        ChunkManager mgr(3);
+        mgr.setMode(ChunkManager::Mode::Procedural, k.seed);
+        mgr.setContinents(k.continents);
+        mgr.generateChunks({ChunkKey{k.cx, k.cy}, ChunkKey{k.cx + 1, k.cy}, ChunkKey{k.cx, k.cy - 1}});
+        const Chunk& ch = mgr.getChunk(k.cx, k.cy, ChunkManager::Layer::Generated);
+        std::vector<int16_t> bg;
+        const std::string name = "chunk " + std::to_string(k.seed) + " " + (k.continents ? "1" : "0") + " " +
+                                 std::to_string(k.cx) + " " + std::to_string(k.cy);
+        if (err.empty() && !staged(k, bg)) err = name + ": background generation did not finish";
+        else if (err.empty() && !std::equal(bg.begin(), bg.end(), ch.heightData()))
+            err = name + ": background generation (preview, then refinement) differs from the batch";
+        Case c;
+        c.header = name;
+        for (int i = 0; i < N; ++i) {
+            std::string line;
+            for (int j = 0; j < N; ++j) {
+                const int v = ch.height(Chunk::idx(i, j));
+                c.hash = fnv(c.hash, (uint16_t)v, 2);
+                line += (j ? " " : "") + std::to_string(v);
+            }
+            c.rows.push_back(line);
+        }
+        out.push_back(std::move(c));
+    }
+    return out;
+}
+
+// terrain::generateMap, single-threaded and in row bands on a pool (both must match)
+std::vector<Case> mapCases(std::string& err) {
+    std::vector<Case> out;
+    const int N = cfg::GRID + 1;
+    ThreadPool pool(3);
+    for (uint32_t seed : MAP_SEEDS) {
+        std::vector<int> serial, banded;
+        terrain::generateMap(serial, seed);
+        terrain::generateMap(banded, seed, &pool);
+        Case c;
+        c.header = "map " + std::to_string(seed);
+        for (int i = 0; i < N; ++i) {
+            uint64_t row = FNV0;
+            for (int j = 0; j < N; ++j) row = fnv(row, (uint16_t)serial[(size_t)i * N + j], 2);
+            c.hash = fnv(c.hash, (uint32_t)row, 4);
+            c.hash = fnv(c.hash, (uint32_t)(row >> 32), 4);
+            c.rows.push_back(hex(row, 16));
+        }
+        if (serial != banded && err.empty()) err = c.header + ": generateMap on a pool differs from the single-threaded result";
+        out.push_back(std::move(c));
+    }
+    return out;
+}
+
+bool readGolden(const std::string& path, std::vector<Case>& out) {
+    std::ifstream in(path);
+    if (!in) return false;
+    std::string line;
+    Case* cur = nullptr;
+    while (std::getline(in, line)) {
+        if (line.empty() || line[0] == '#') continue;
+        if (line.rfind("noise ", 0) == 0 || line.rfind("chunk ", 0) == 0 || line.rfind("map ", 0) == 0) {
+            // "<header> hash=<hex>"
+            const size_t h = line.find(" hash=");
+            if (h == std::string::npos) return false;
+            out.emplace_back();
+            cur = &out.back();
+            cur->header = line.substr(0, h);
+            cur->hash = std::stoull(line.substr(h + 6), nullptr, 16);
+        } else if (cur) {
+            cur->rows.push_back(line);
+        }
+    }
+    return true;
+}
+
+bool writeGolden(const std::string& path, const std::vector<Case>& cases) {
+    std::ofstream out(path, std::ios::trunc);
+    if (!out) return false;
+    out << "# Golden generation data, checked by `make test` (tests/golden.cpp).\n"
+        << "# Regenerate with `make test TEST_ARGS=--update` only for intended terrain changes.\n";
+    for (const Case& c : cases) {
+        out << c.header << " hash=" << hex(c.hash, 16) << "\n";
+        for (const std::string& r : c.rows) out << r << "\n";
+    }
+    return (bool)out;
+}
+
+std::vector<std::string> fields(const std::string& s) {
+    std::istringstream in(s);
+    std::vector<std::string> f;
+    for (std::string w; in >> w; ) f.push_back(w);
+    return f;
+}
+
+// First difference between the golden and generated data of one case
+void reportDiff(const Case& want, const Case& got) {
+    const std::vector<std::string> h = fields(got.header);
+    for (size_t r = 0; r < got.rows.size(); ++r) {
+        const std::vector<std::string> a = fields(r < want.rows.size() ? want.rows[r] : std::string());
+        const std::vector<std::string> b = fields(got.rows[r]);
+        for (size_t t = 0; t < b.size(); ++t) {
+            const std::string expected = t < a.size() ? a[t] : "(missing)";
+            if (expected == b[t]) continue;
+            if (h[0] == "chunk") {
+                const int I = std::stoi(h[3]) * cfg::CHUNK_SIZE + (int)r, J = std::stoi(h[4]) * cfg::CHUNK_SIZE + (int)t;
+                std::printf("  first differing vertex: local (%zu, %zu), world (%d, %d): expected %s, got %s\n",
+                            r, t, I, J, expected.c_str(), b[t].c_str());
+            } else if (h[0] == "map") {
+                std::printf("  first differing row: i = %zu (row hash expected %s, got %s)\n", r, expected.c_str(), b[t].c_str());
+            } else {
+                std::printf("  first differing sample: %zu (bits expected %s, got %s)\n", t, expected.c_str(), b[t].c_str());
+            }
+            return;
+        }
+    }
+    std::printf("  data matches; only the stored hash differs (golden file edited by hand?)\n");
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::printf("usage: golden <golden.txt> [--update]\n");
+        return 2;
+    }
+    const fs::path golden = fs::absolute(argv[1]);
+    const bool update = argc > 2 && std::strcmp(argv[2], "--update") == 0;
+
+    // Generate in an empty directory: ChunkManager opens maps/seed_* relative to the working
+    // directory, and the persisted edits there must not leak in
+    std::error_code ec;
+    const fs::path work = fs::temp_directory_path(ec) / "sfml-myworld-golden";
+    fs::remove_all(work, ec);
+    fs::create_directories(work, ec);
+    fs::current_path(work, ec);
+    if (ec) {
+        std::printf("cannot enter %s: %s\n", work.string().c_str(), ec.message().c_str());
+        return 2;
+    }
+
+    std::string err;
+    std::vector<Case> cases;
+    cases.push_back(noiseCase());
+    for (Case& c : chunkCases(err)) cases.push_back(std::move(c));
+    for (Case& c : mapCases(err)) cases.push_back(std::move(c));
+    fs::current_path(golden.parent_path(), ec);
+    fs::remove_all(work, ec);
+
+    if (update) {
+        if (!writeGolden(golden.string(), cases)) {
+            std::printf("cannot write %s\n", golden.string().c_str());
+            return 2;
+        }
+        std::printf("wrote %zu cases to %s\n", cases.size(), golden.string().c_str());
+        return 0;
+    }
+
+    std::vector<Case> want;
+    if (!readGolden(golden.string(), want)) {
+        std::printf("cannot read %s (create it with --update)\n", golden.string().c_str());
+        return 2;
+    }
+    int failed = 0;
+    if (!err.empty()) { std::printf("FAIL %s\n", err.c_str()); ++failed; }
+    for (const Case& c : cases) {
+        const Case* w = nullptr;
+        for (const Case& x : want) if (x.header == c.header) { w = &x; break; }
+        if (!w) { std::printf("FAIL %s: not in the golden file\n", c.header.c_str()); ++failed; continue; }
+        if (w->hash == c.hash) continue;
+        std::printf("FAIL %s: hash expected %s, got %s\n", c.header.c_str(), hex(w->hash, 16).c_str(), hex(c.hash, 16).c_str());
+        reportDiff(*w, c);
+        ++failed;
+    }
+    if (failed) {
+        std::printf("%d of %zu cases differ\n", failed, cases.size());
+        return 1;
+    }
+    std::printf("ok: %zu cases match (%s batched noise)\n", cases.size(), noise::simdPath());
+    return 0;
+}
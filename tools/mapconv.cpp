@@ -0,0 +1,37 @@
+// mapconv - fold legacy per-chunk overrides (maps/seed_*/cX_Y.csv or .mwc) into region files
+// Usage: mapconv [dir...]   (default: every world directory under maps/)
+// Each source is renamed to <name>.bak once its region slot is verified; the app only reads them.
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "regionfile.hpp"
+
+namespace fs = std::filesystem;
+
+int main(int argc, char** argv) {
+    std::vector<std::string> dirs;
+    for (int a = 1; a < argc; ++a) {
+        std::string arg = argv[a];
+        if (arg == "-h" || arg == "--help") {
+            std::cout << "usage: mapconv [dir...]\n";
+            return 0;
+        }
+        dirs.push_back(arg);
+    }
+    if (dirs.empty()) {
+        std::error_code ec;
+        for (const auto& de : fs::directory_iterator("maps", ec)) {
+            if (de.is_directory(ec)) dirs.push_back(de.path().string());
+        }
+    }
+    RegionStore store;
+    int total = 0;
+    for (const auto& d : dirs) {
+        int n = store.migrateLegacy(d);
+        std::cout << d << ": " << n << " chunk(s) converted\n";
+        total += n;
+    }
+    std::cout << "total: " << total << "\n";
+    return 0;
+}